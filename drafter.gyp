@@ -73,6 +73,7 @@
       ],
       'sources': [
         'ext/snowcrash/ext/markdown-parser/test/test-ByteBuffer.cc',
+        'ext/snowcrash/ext/markdown-parser/test/test-MarkdownNode.cc',
         'ext/snowcrash/ext/markdown-parser/test/test-MarkdownParser.cc',
         'ext/snowcrash/ext/markdown-parser/test/test-libmarkdownparser.cc'
       ],
@@ -101,6 +102,8 @@
         'ext/snowcrash/src/MSONSourcemap.cc',
         'ext/snowcrash/src/MSONTypeSectionParser.cc',
         'ext/snowcrash/src/MSONValueMemberParser.cc',
+        'ext/snowcrash/src/Profile.cc',
+        'ext/snowcrash/src/Profile.h',
         'ext/snowcrash/src/Blueprint.cc',
         'ext/snowcrash/src/BlueprintSourcemap.cc',
         'ext/snowcrash/src/Section.cc',
@@ -189,6 +192,7 @@
         'ext/snowcrash/test/test-ParameterParser.cc',
         'ext/snowcrash/test/test-ParametersParser.cc',
         'ext/snowcrash/test/test-PayloadParser.cc',
+        'ext/snowcrash/test/test-Profile.cc',
         'ext/snowcrash/test/test-RegexMatch.cc',
         'ext/snowcrash/test/test-RelationParser.cc',
         'ext/snowcrash/test/test-ResourceParser.cc',
@@ -219,6 +223,15 @@
       ]
     },
 
+# GENERATE-BLUEPRINT
+    {
+      'target_name': 'generate-blueprint',
+      'type': 'executable',
+      'sources': [
+        'ext/snowcrash/test/performance/generate-blueprint.cc'
+      ]
+    },
+
 # LIBSOS
     {
       'target_name': 'libsos',
@@ -277,6 +290,11 @@
         "src/RefractElementFactory.cc",
         "src/ConversionContext.cc",
         "src/ConversionContext.h",
+        "src/DrafterResult.h",
+        "src/ResultAssets.h",
+        "src/ResultAssets.cc",
+        "src/TaskPool.h",
+        "src/TaskPool.cc",
 
         # librefract parts - will be separated into other project
         "src/refract/Element.h",
@@ -302,6 +320,12 @@
         "src/refract/ExpandVisitor.cc",
         "src/refract/RenderJSONVisitor.h",
         "src/refract/RenderJSONVisitor.cc",
+        "src/refract/JSONWriter.h",
+        "src/refract/JSONWriter.cc",
+        "src/refract/JSONValue.h",
+        "src/refract/JSONValue.cc",
+        "src/refract/JSONSchemaCache.h",
+        "src/refract/JSONSchemaCache.cc",
         "src/refract/PrintVisitor.h",
         "src/refract/PrintVisitor.cc",
         "src/refract/JSONSchemaVisitor.h",
@@ -311,6 +335,9 @@
         "src/refract/Registry.h",
         "src/refract/Registry.cc",
 
+        "src/refract/Symbol.h",
+        "src/refract/Symbol.cc",
+
         "src/refract/Build.h",
 
         "src/refract/ElementInserter.h",
@@ -348,6 +375,10 @@
         "test/test-OneOfTest.cc",
         "test/test-SyntaxIssuesTest.cc",
         "test/test-ElementDataTest.cc",
+        "test/test-SymbolTest.cc",
+        "test/test-RegistryTest.cc",
+        "test/test-JSONWriterTest.cc",
+        "test/test-JSONSchemaVisitorTest.cc",
       ],
       'dependencies': [
         "libdrafter",
@@ -357,6 +388,21 @@
       ],
     },
 
+# PERF-LIBDRAFTER
+    {
+      'target_name': 'perf-libdrafter',
+      'type': 'executable',
+      "conditions" : [
+        [ 'libdrafter_type=="static_library"', { 'defines' : [ 'DRAFTER_BUILD_STATIC' ] }],
+      ],
+      'sources': [
+        'test/performance/perf-drafter.cc'
+      ],
+      'dependencies': [
+        'libdrafter',
+      ]
+    },
+
 # DRAFTER
     {
       "target_name": "drafter",
@@ -6,10 +6,14 @@
 //  Copyright (c) 2014 Apiary Inc. All rights reserved.
 //
 
+#include <cstring>
+#include <stdint.h>
 #include "ByteBuffer.h"
 
 using namespace mdp;
 
+const size_t ByteBufferScan::npos;
+
 /* Byte lenght of an UTF8 character (based on first byte) */
 #define UTF8_CHAR_LEN(byte) ((0xE5000000 >> ((byte >> 3) & 0x1e)) & 3) + 1
 
@@ -85,27 +89,104 @@ static CharactersRange BytesRangeToCharactersRange(const BytesRange& bytesRange,
     return characterRange;
 }
 
-void mdp::BuildCharacterIndex(ByteBufferCharacterIndex& index, const ByteBuffer& byteBuffer)
+static const uint64_t LowBytes = 0x0101010101010101ULL;
+static const uint64_t HighBits = 0x8080808080808080ULL;
+
+/* True if any byte of the word is zero */
+static inline bool HasZeroByte(uint64_t word)
+{
+    return ((word - LowBytes) & ~word & HighBits) != 0;
+}
+
+/* True if any byte of the word equals to byte */
+static inline bool HasByte(uint64_t word, unsigned char byte)
 {
+    return HasZeroByte(word ^ (LowBytes * byte));
+}
 
-    const char* source = byteBuffer.c_str();
+void mdp::ScanByteBuffer(const ByteBuffer& byteBuffer, ByteBufferScan& scan, ByteBufferCharacterIndex& index)
+{
+    const unsigned char* source = reinterpret_cast<const unsigned char*>(byteBuffer.data());
     size_t len = byteBuffer.length();
     size_t pos = 0;
-    size_t charPos = 0;
 
-    index.resize(byteBuffer.length());
+    scan = ByteBufferScan();
 
-    while (source[pos] && pos < len) {
-        int charLen = UTF8_CHAR_LEN(source[pos]);
-        pos += charLen;
+    // ASCII prefix, a word at a time unless it needs a closer look
+    while (pos < len) {
+
+        if (pos + sizeof(uint64_t) <= len) {
+            uint64_t word;
+            ::memcpy(&word, source + pos, sizeof(word));
 
-        while (charLen) {
-            index[pos - charLen] = charPos;
-            charLen--;
+            if (!(word & HighBits) && !HasZeroByte(word) && !HasByte(word, '\t') && !HasByte(word, '\r')) {
+                pos += sizeof(word);
+                continue;
+            }
         }
 
+        unsigned char c = source[pos];
+
+        if (c == 0 || c >= 0x80) {
+            scan.ascii = false;
+            break;
+        }
+
+        if (c == '\t' && scan.tab == ByteBufferScan::npos)
+            scan.tab = pos;
+
+        if (c == '\r' && scan.carriageReturn == ByteBufferScan::npos)
+            scan.carriageReturn = pos;
+
+        ++pos;
+    }
+
+    index.m_size = len;
+    index.m_map.clear();
+
+    if (scan.ascii)
+        return;
+
+    // Characters and bytes match up to the first non ASCII one
+    index.m_map.resize(len);
+
+    for (size_t i = 0; i < pos; ++i) {
+        index.m_map[i] = i;
+    }
+
+    size_t charPos = pos;
+
+    while (pos < len && source[pos]) {
+        size_t charLen = UTF8_CHAR_LEN(source[pos]);
+
+        for (size_t i = pos; i < pos + charLen && i < len; ++i) {
+            index.m_map[i] = charPos;
+
+            if (source[i] == '\t' && scan.tab == ByteBufferScan::npos)
+                scan.tab = i;
+
+            if (source[i] == '\r' && scan.carriageReturn == ByteBufferScan::npos)
+                scan.carriageReturn = i;
+        }
+
+        pos += charLen;
         charPos++;
     }
+
+    // Bytes past NUL are not indexed but still checked
+    for (; pos < len; ++pos) {
+        if (source[pos] == '\t' && scan.tab == ByteBufferScan::npos)
+            scan.tab = pos;
+
+        if (source[pos] == '\r' && scan.carriageReturn == ByteBufferScan::npos)
+            scan.carriageReturn = pos;
+    }
+}
+
+void mdp::BuildCharacterIndex(ByteBufferCharacterIndex& index, const ByteBuffer& byteBuffer)
+{
+    ByteBufferScan scan;
+    ScanByteBuffer(byteBuffer, scan, index);
 }
 
 CharactersRangeSet mdp::BytesRangeSetToCharactersRangeSet(const BytesRangeSet& rangeSet, const ByteBuffer& byteBuffer)
@@ -70,8 +70,65 @@ namespace mdp
     /** Set of non-continuous character ranges */
     typedef RangeSet<CharactersRange> CharactersRangeSet;
 
-    /** Map byte index into utf-8 chracter index */
-    typedef std::vector<size_t> ByteBufferCharacterIndex;
+    /** Properties of byte buffer found by ScanByteBuffer() */
+    struct ByteBufferScan {
+        size_t tab;            /// < Position of the first tab, `npos` if none
+        size_t carriageReturn; /// < Position of the first carriage return, `npos` if none
+        bool ascii;            /// < True if the buffer contains only (non-NUL) ASCII characters
+
+        static const size_t npos = static_cast<size_t>(-1);
+
+        ByteBufferScan() : tab(npos), carriageReturn(npos), ascii(true) {}
+    };
+
+    /**
+     *  \brief Map byte index into utf-8 chracter index
+     *
+     *  Byte and character indexes of an ASCII only buffer are
+     *  the same, no map is kept for such a buffer.
+     */
+    class ByteBufferCharacterIndex
+    {
+    public:
+        ByteBufferCharacterIndex() : m_size(0) {}
+
+        /** Number of indexed bytes */
+        size_t size() const
+        {
+            return m_size;
+        }
+
+        bool empty() const
+        {
+            return m_size == 0;
+        }
+
+        /** Character index of byte at given position */
+        size_t operator[](size_t pos) const
+        {
+            return m_map.empty() ? pos : m_map[pos];
+        }
+
+        void swap(ByteBufferCharacterIndex& other)
+        {
+            m_map.swap(other.m_map);
+            std::swap(m_size, other.m_size);
+        }
+
+    private:
+        std::vector<size_t> m_map;
+        size_t m_size;
+
+        friend void ScanByteBuffer(const ByteBuffer&, ByteBufferScan&, ByteBufferCharacterIndex&);
+    };
+
+    /**
+     *  \brief Scan byte buffer in a single pass
+     *
+     *  Finds tabs and carriage returns and fills the character index.
+     *  ASCII content is scanned a machine word at a time.
+     */
+    void ScanByteBuffer(const ByteBuffer& byteBuffer, ByteBufferScan& scan, ByteBufferCharacterIndex& index);
 
     /** Fill character map - cache of characters positions */
     void BuildCharacterIndex(ByteBufferCharacterIndex& index, const ByteBuffer& byteBuffer);
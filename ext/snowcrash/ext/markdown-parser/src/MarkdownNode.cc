@@ -10,34 +10,64 @@
 
 using namespace mdp;
 
-MarkdownNode::MarkdownNode(MarkdownNodeType type_, MarkdownNode* parent_, const ByteBuffer& text_, const Data& data_)
-    : type(type_), text(text_), data(data_), m_parent(parent_)
+void MarkdownNodes::link(MarkdownNode& node)
 {
-    m_children.reset(::new MarkdownNodes);
+    MarkdownNodes& children = node.children();
+
+    for (size_t i = children.m_first; i < children.m_first + children.m_size; ++i) {
+        (*children.m_arena)[i].setParent(&node);
+    }
 }
 
-MarkdownNode::MarkdownNode(const MarkdownNode& rhs)
+void MarkdownNodes::relink(MarkdownNodeArena& arena)
 {
-    this->type = rhs.type;
-    this->text = rhs.text;
-    this->data = rhs.data;
-    this->sourceMap = rhs.sourceMap;
-    this->m_children.reset(::new MarkdownNodes(*rhs.m_children.get()));
-    this->m_parent = rhs.m_parent;
+    // Children built in arena of their own point back into this one as well
+    for (MarkdownNodeArena::iterator it = arena.begin(); it != arena.end(); ++it) {
+        link(*it);
+    }
+}
+
+void MarkdownNodes::push_back(const MarkdownNode& node)
+{
+    if (!m_arena) {
+        m_storage = std::make_shared<MarkdownNodeArena>();
+        m_arena = m_storage.get();
+        m_first = 0;
+    }
+
+    size_t first = m_first;
+    size_t capacity = m_arena->capacity();
+    bool relocated = m_first + m_size != m_arena->size();
+
+    // Keep the collection continuous
+    if (relocated) {
+        first = m_arena->size();
+        m_arena->reserve(first + m_size + 1);
+
+        for (size_t i = 0; i < m_size; ++i) {
+            m_arena->push_back((*m_arena)[m_first + i]);
+        }
+    }
+
+    m_arena->push_back(node);
+    m_first = first;
+    ++m_size;
+
+    if (relocated || m_arena->capacity() != capacity)
+        relink(*m_arena);
+    else
+        link(m_arena->back());
 }
 
-MarkdownNode& MarkdownNode::operator=(const MarkdownNode& rhs)
+MarkdownNode::MarkdownNode(MarkdownNodeType type_, MarkdownNode* parent_, const ByteBuffer& text_, const Data& data_)
+    : type(type_), text(text_), data(data_), m_parent(parent_)
 {
-    this->type = rhs.type;
-    this->text = rhs.text;
-    this->data = rhs.data;
-    this->sourceMap = rhs.sourceMap;
-    this->m_children.reset(::new MarkdownNodes(*rhs.m_children.get()));
-    this->m_parent = rhs.m_parent;
-    return *this;
 }
 
-MarkdownNode::~MarkdownNode() {}
+MarkdownNode::MarkdownNode(MarkdownNodeType type_, MarkdownNode* parent_, ByteBuffer&& text_, const Data& data_)
+    : type(type_), text(std::move(text_)), data(data_), m_parent(parent_)
+{
+}
 
 MarkdownNode& MarkdownNode::parent()
 {
@@ -65,18 +95,12 @@ bool MarkdownNode::hasParent() const
 
 MarkdownNodes& MarkdownNode::children()
 {
-    if (!m_children.get())
-        throw "no children set";
-
-    return *m_children;
+    return m_children;
 }
 
 const MarkdownNodes& MarkdownNode::children() const
 {
-    if (!m_children.get())
-        throw "no children set";
-
-    return *m_children;
+    return m_children;
 }
 
 void MarkdownNode::printNode(size_t level) const
@@ -136,7 +160,7 @@ void MarkdownNode::printNode(size_t level) const
 
     cout << std::endl;
 
-    for (MarkdownNodeIterator it = m_children->begin(); it != m_children->end(); ++it) {
+    for (MarkdownNodeIterator it = m_children.begin(); it != m_children.end(); ++it) {
         it->printNode(level + 1);
     }
 
@@ -9,8 +9,10 @@
 #ifndef MARKDOWNPARSER_NODE_H
 #define MARKDOWNPARSER_NODE_H
 
-#include <deque>
+#include <vector>
 #include <memory>
+#include <iterator>
+#include <cstddef>
 #include <iostream>
 #include "ByteBuffer.h"
 
@@ -39,8 +41,195 @@ namespace mdp
     /* Forward declaration of AST Node */
     class MarkdownNode;
 
-    /** Markdown AST nodes collection */
-    typedef std::deque<MarkdownNode> MarkdownNodes;
+    /**
+     *  \brief Storage of all nodes of an AST
+     *
+     *  Nodes are laid out breadth-first so children
+     *  of every node form a continuous block.
+     */
+    typedef std::vector<MarkdownNode> MarkdownNodeArena;
+
+    /**
+     *  \brief Markdown AST nodes collection iterator
+     *
+     *  Random access iterator addressing a node by its index in
+     *  the arena, it stays valid as long as the arena does.
+     */
+    class MarkdownNodeIterator
+    {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef MarkdownNode value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef MarkdownNode* pointer;
+        typedef MarkdownNode& reference;
+
+        MarkdownNodeIterator() : m_arena(NULL), m_index(0) {}
+        MarkdownNodeIterator(MarkdownNodeArena* arena, size_t index) : m_arena(arena), m_index(index) {}
+
+        reference operator*() const;
+        pointer operator->() const;
+        reference operator[](difference_type n) const;
+
+        MarkdownNodeIterator& operator++()
+        {
+            ++m_index;
+            return *this;
+        }
+
+        MarkdownNodeIterator operator++(int)
+        {
+            MarkdownNodeIterator tmp(*this);
+            ++m_index;
+            return tmp;
+        }
+
+        MarkdownNodeIterator& operator--()
+        {
+            --m_index;
+            return *this;
+        }
+
+        MarkdownNodeIterator operator--(int)
+        {
+            MarkdownNodeIterator tmp(*this);
+            --m_index;
+            return tmp;
+        }
+
+        MarkdownNodeIterator& operator+=(difference_type n)
+        {
+            m_index += n;
+            return *this;
+        }
+
+        MarkdownNodeIterator& operator-=(difference_type n)
+        {
+            m_index -= n;
+            return *this;
+        }
+
+        MarkdownNodeIterator operator+(difference_type n) const
+        {
+            return MarkdownNodeIterator(m_arena, m_index + n);
+        }
+
+        MarkdownNodeIterator operator-(difference_type n) const
+        {
+            return MarkdownNodeIterator(m_arena, m_index - n);
+        }
+
+        difference_type operator-(const MarkdownNodeIterator& rhs) const
+        {
+            return static_cast<difference_type>(m_index) - static_cast<difference_type>(rhs.m_index);
+        }
+
+        bool operator==(const MarkdownNodeIterator& rhs) const
+        {
+            return m_index == rhs.m_index && m_arena == rhs.m_arena;
+        }
+
+        bool operator!=(const MarkdownNodeIterator& rhs) const
+        {
+            return !(*this == rhs);
+        }
+
+        bool operator<(const MarkdownNodeIterator& rhs) const
+        {
+            return m_index < rhs.m_index;
+        }
+
+        bool operator>(const MarkdownNodeIterator& rhs) const
+        {
+            return rhs < *this;
+        }
+
+        bool operator<=(const MarkdownNodeIterator& rhs) const
+        {
+            return !(rhs < *this);
+        }
+
+        bool operator>=(const MarkdownNodeIterator& rhs) const
+        {
+            return !(*this < rhs);
+        }
+
+    private:
+        MarkdownNodeArena* m_arena;
+        size_t m_index;
+    };
+
+    /**
+     *  \brief Markdown AST nodes collection
+     *
+     *  Continuous range of sibling nodes in an arena. Copies of
+     *  the collection refer to the same nodes. A collection not
+     *  backed by any arena creates its own one on the first
+     *  `push_back()`.
+     */
+    class MarkdownNodes
+    {
+    public:
+        typedef MarkdownNode value_type;
+        typedef MarkdownNode& reference;
+        typedef const MarkdownNode& const_reference;
+        typedef MarkdownNodeIterator iterator;
+        typedef MarkdownNodeIterator const_iterator;
+        typedef size_t size_type;
+
+        MarkdownNodes() : m_arena(NULL), m_first(0), m_size(0) {}
+
+        iterator begin() const
+        {
+            return iterator(m_arena, m_first);
+        }
+
+        iterator end() const
+        {
+            return iterator(m_arena, m_first + m_size);
+        }
+
+        size_type size() const
+        {
+            return m_size;
+        }
+
+        bool empty() const
+        {
+            return m_size == 0;
+        }
+
+        reference front() const;
+        reference back() const;
+        reference operator[](size_type n) const;
+
+        /**
+         *  \brief Append a copy of node to the collection
+         *
+         *  If the collection is not at the end of its arena it is
+         *  moved there first. Unlike the deque the nodes used to be
+         *  kept in, it invalidates references to the nodes of the
+         *  arena, not the iterators. Parents of all nodes in the arena,
+         *  including children of the appended node, are updated.
+         */
+        void push_back(const MarkdownNode& node);
+
+    private:
+        MarkdownNodeArena* m_arena;
+        size_t m_first;
+        size_t m_size;
+
+        /** Arena owned by the collection, if any */
+        std::shared_ptr<MarkdownNodeArena> m_storage;
+
+        /** Point parents of children of node back to the node */
+        static void link(MarkdownNode& node);
+
+        /** Point parents of children of all nodes in arena back to their nodes */
+        static void relink(MarkdownNodeArena& arena);
+
+        friend class MarkdownParser;
+    };
 
     /**
      *  AST node
@@ -76,31 +265,60 @@ namespace mdp
         MarkdownNodes& children();
         const MarkdownNodes& children() const;
 
-        /** Constructor */
+        /**
+         *  \brief Constructor
+         *
+         *  Copies of a node are shallow, they share its children
+         *  and the children keep pointing to the original node.
+         */
         MarkdownNode(MarkdownNodeType type_ = UndefinedMarkdownNodeType,
             MarkdownNode* parent_ = NULL,
             const ByteBuffer& text_ = ByteBuffer(),
             const Data& data_ = Data());
 
-        /** Copy constructor */
-        MarkdownNode(const MarkdownNode& rhs);
-
-        /** Assignment operator */
-        MarkdownNode& operator=(const MarkdownNode& rhs);
-
-        /** Destructor */
-        ~MarkdownNode();
+        /** Constructor taking over the text */
+        MarkdownNode(MarkdownNodeType type_, MarkdownNode* parent_, ByteBuffer&& text_, const Data& data_ = Data());
 
         /** Prints the node to the stdout */
         void printNode(size_t level = 0) const;
 
     private:
         MarkdownNode* m_parent;
-        std::unique_ptr<MarkdownNodes> m_children;
+        MarkdownNodes m_children;
+
+        friend class MarkdownNodes;
+        friend class MarkdownParser;
     };
 
-    /** Markdown AST nodes collection iterator */
-    typedef MarkdownNodes::iterator MarkdownNodeIterator;
+    inline MarkdownNodeIterator::reference MarkdownNodeIterator::operator*() const
+    {
+        return (*m_arena)[m_index];
+    }
+
+    inline MarkdownNodeIterator::pointer MarkdownNodeIterator::operator->() const
+    {
+        return &(*m_arena)[m_index];
+    }
+
+    inline MarkdownNodeIterator::reference MarkdownNodeIterator::operator[](difference_type n) const
+    {
+        return (*m_arena)[m_index + n];
+    }
+
+    inline MarkdownNodes::reference MarkdownNodes::front() const
+    {
+        return (*m_arena)[m_first];
+    }
+
+    inline MarkdownNodes::reference MarkdownNodes::back() const
+    {
+        return (*m_arena)[m_first + m_size - 1];
+    }
+
+    inline MarkdownNodes::reference MarkdownNodes::operator[](size_type n) const
+    {
+        return (*m_arena)[m_first + n];
+    }
 }
 
 #endif
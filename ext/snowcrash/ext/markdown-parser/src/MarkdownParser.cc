@@ -16,6 +16,7 @@ const size_t MarkdownParser::OutputUnitSize = 64;
 const size_t MarkdownParser::MaxNesting = 128;
 const int MarkdownParser::ParserExtensions
     = MKDEXT_FENCED_CODE | MKDEXT_NO_INTRA_EMPHASIS | MKDEXT_LAX_SPACING /*| MKDEXT_TABLES */;
+const size_t MarkdownParser::NoNode = static_cast<size_t>(-1);
 
 #define NO_WORKING_NODE_ERR std::logic_error("no working node")
 #define WORKING_NODE_MISMATCH_ERR std::logic_error("working node mismatch")
@@ -31,14 +32,19 @@ static ByteBuffer ByteBufferFromSundown(const struct buf* text)
     return ByteBuffer(reinterpret_cast<char*>(text->data), text->size);
 }
 
-MarkdownParser::MarkdownParser() : m_workingNode(NULL), m_listBlockContext(false), m_source(NULL), m_sourceLength(0) {}
+MarkdownParser::MarkdownParser()
+    : m_workingNode(NoNode), m_listBlockContext(false), m_source(NULL), m_sourceLength(0)
+{
+}
 
 void MarkdownParser::parse(const ByteBuffer& source, MarkdownNode& ast)
 {
-    ast = MarkdownNode();
-    m_workingNode = &ast;
-    m_workingNode->type = RootMarkdownNodeType;
-    m_workingNode->sourceMap.push_back(BytesRange(0, source.length()));
+    m_nodes.clear();
+    m_links.clear();
+    m_workingNode = NoNode;
+
+    m_workingNode = addNode(MarkdownNode(RootMarkdownNodeType));
+    m_nodes[m_workingNode].sourceMap.push_back(BytesRange(0, source.length()));
     m_source = &source;
     m_sourceLength = source.length();
     m_listBlockContext = false;
@@ -53,7 +59,11 @@ void MarkdownParser::parse(const ByteBuffer& source, MarkdownNode& ast)
     ::bufrelease(output);
     ::sd_markdown_free(sundown);
 
-    m_workingNode = NULL;
+    buildAST(ast);
+
+    m_nodes.clear();
+    m_links.clear();
+    m_workingNode = NoNode;
     m_source = NULL;
     m_sourceLength = 0;
     m_listBlockContext = false;
@@ -63,6 +73,63 @@ void MarkdownParser::parse(const ByteBuffer& source, MarkdownNode& ast)
 #endif
 }
 
+size_t MarkdownParser::addNode(MarkdownNode&& node, bool first)
+{
+    size_t index = m_nodes.size();
+    NodeLinks links = { m_workingNode, NoNode, NoNode, NoNode };
+
+    m_nodes.push_back(std::move(node));
+    m_links.push_back(links);
+
+    if (m_workingNode == NoNode)
+        return index;
+
+    NodeLinks& parent = m_links[m_workingNode];
+
+    if (parent.firstChild == NoNode) {
+        parent.firstChild = parent.lastChild = index;
+    } else if (first) {
+        m_links[index].nextSibling = parent.firstChild;
+        parent.firstChild = index;
+    } else {
+        m_links[parent.lastChild].nextSibling = index;
+        parent.lastChild = index;
+    }
+
+    return index;
+}
+
+void MarkdownParser::buildAST(MarkdownNode& ast)
+{
+    std::shared_ptr<MarkdownNodeArena> arena = std::make_shared<MarkdownNodeArena>();
+    arena->reserve(m_nodes.size() - 1);
+
+    // Root node is the AST itself, so its children point to it
+    ast = std::move(m_nodes[0]);
+
+    // Breadth-first, children of a node end up next to each other
+    std::vector<size_t> order;
+    order.reserve(m_nodes.size());
+    order.push_back(0);
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        MarkdownNode& node = i ? (*arena)[i - 1] : ast;
+
+        node.m_children.m_arena = arena.get();
+        node.m_children.m_first = arena->size();
+        node.m_children.m_size = 0;
+
+        for (size_t child = m_links[order[i]].firstChild; child != NoNode; child = m_links[child].nextSibling) {
+            order.push_back(child);
+            arena->push_back(std::move(m_nodes[child]));
+            arena->back().m_parent = &node;
+            ++node.m_children.m_size;
+        }
+    }
+
+    ast.m_children.m_storage = arena;
+}
+
 MarkdownParser::RenderCallbacks MarkdownParser::renderCallbacks()
 {
     RenderCallbacks callbacks;
@@ -104,13 +171,12 @@ void MarkdownParser::renderHeader(struct buf* ob, const struct buf* text, int le
     p->renderHeader(ByteBufferFromSundown(text), level);
 }
 
-void MarkdownParser::renderHeader(const ByteBuffer& text, int level)
+void MarkdownParser::renderHeader(ByteBuffer text, int level)
 {
-    if (!m_workingNode)
+    if (m_workingNode == NoNode)
         throw NO_WORKING_NODE_ERR;
 
-    MarkdownNode node(HeaderMarkdownNodeType, m_workingNode, text, level);
-    m_workingNode->children().push_back(node);
+    addNode(MarkdownNode(HeaderMarkdownNodeType, NULL, std::move(text), level));
 }
 
 void MarkdownParser::beginList(int flags, void* opaque)
@@ -124,7 +190,7 @@ void MarkdownParser::beginList(int flags, void* opaque)
 
 void MarkdownParser::beginList(int flags)
 {
-    if (!m_workingNode)
+    if (m_workingNode == NoNode)
         throw NO_WORKING_NODE_ERR;
 }
 
@@ -134,10 +200,10 @@ void MarkdownParser::renderList(struct buf* ob, const struct buf* text, int flag
         return;
 
     MarkdownParser* p = static_cast<MarkdownParser*>(opaque);
-    p->renderList(ByteBufferFromSundown(text), flags);
+    p->renderList(flags);
 }
 
-void MarkdownParser::renderList(const ByteBuffer& text, int flags)
+void MarkdownParser::renderList(int flags)
 {
     m_listBlockContext = true;
 }
@@ -153,14 +219,11 @@ void MarkdownParser::beginListItem(int flags, void* opaque)
 
 void MarkdownParser::beginListItem(int flags)
 {
-    if (!m_workingNode)
+    if (m_workingNode == NoNode)
         throw NO_WORKING_NODE_ERR;
 
-    MarkdownNode node(ListItemMarkdownNodeType, m_workingNode, ByteBuffer(), flags);
-    m_workingNode->children().push_back(node);
-
     // Push context
-    m_workingNode = &m_workingNode->children().back();
+    m_workingNode = addNode(MarkdownNode(ListItemMarkdownNodeType, NULL, ByteBuffer(), flags));
 }
 
 void MarkdownParser::renderListItem(struct buf* ob, const struct buf* text, int flags, void* opaque)
@@ -169,29 +232,30 @@ void MarkdownParser::renderListItem(struct buf* ob, const struct buf* text, int
         return;
 
     MarkdownParser* p = static_cast<MarkdownParser*>(opaque);
-    p->renderListItem(ByteBufferFromSundown(text), flags);
+    p->renderListItem(text, flags);
 }
 
-void MarkdownParser::renderListItem(const ByteBuffer& text, int flags)
+void MarkdownParser::renderListItem(const struct buf* text, int flags)
 {
-    if (!m_workingNode)
+    if (m_workingNode == NoNode)
         throw NO_WORKING_NODE_ERR;
 
-    if (m_workingNode->type != ListItemMarkdownNodeType)
+    if (m_nodes[m_workingNode].type != ListItemMarkdownNodeType)
         throw WORKING_NODE_MISMATCH_ERR;
 
     // No "inline" list items:
     // Instead of storing the text on the list item
     // create the artificial paragraph node to store the text.
-    if (m_workingNode->children().empty() || m_workingNode->children().front().type != ParagraphMarkdownNodeType) {
-        MarkdownNode textNode(ParagraphMarkdownNodeType, m_workingNode, text);
-        m_workingNode->children().push_front(textNode);
+    size_t firstChild = m_links[m_workingNode].firstChild;
+
+    if (firstChild == NoNode || m_nodes[firstChild].type != ParagraphMarkdownNodeType) {
+        addNode(MarkdownNode(ParagraphMarkdownNodeType, NULL, ByteBufferFromSundown(text)), true);
     }
 
-    m_workingNode->data = flags;
+    m_nodes[m_workingNode].data = flags;
 
     // Pop context
-    m_workingNode = &m_workingNode->parent();
+    m_workingNode = m_links[m_workingNode].parent;
 }
 
 void MarkdownParser::renderBlockCode(struct buf* ob, const struct buf* text, const struct buf* lang, void* opaque)
@@ -200,16 +264,15 @@ void MarkdownParser::renderBlockCode(struct buf* ob, const struct buf* text, con
         return;
 
     MarkdownParser* p = static_cast<MarkdownParser*>(opaque);
-    p->renderBlockCode(ByteBufferFromSundown(text), ByteBufferFromSundown(lang));
+    p->renderBlockCode(ByteBufferFromSundown(text));
 }
 
-void MarkdownParser::renderBlockCode(const ByteBuffer& text, const ByteBuffer& language)
+void MarkdownParser::renderBlockCode(ByteBuffer text)
 {
-    if (!m_workingNode)
+    if (m_workingNode == NoNode)
         throw NO_WORKING_NODE_ERR;
 
-    MarkdownNode node(CodeMarkdownNodeType, m_workingNode, text);
-    m_workingNode->children().push_back(node);
+    addNode(MarkdownNode(CodeMarkdownNodeType, NULL, std::move(text)));
 }
 
 void MarkdownParser::renderParagraph(struct buf* ob, const struct buf* text, void* opaque)
@@ -221,13 +284,12 @@ void MarkdownParser::renderParagraph(struct buf* ob, const struct buf* text, voi
     p->renderParagraph(ByteBufferFromSundown(text));
 }
 
-void MarkdownParser::renderParagraph(const ByteBuffer& text)
+void MarkdownParser::renderParagraph(ByteBuffer text)
 {
-    if (!m_workingNode)
+    if (m_workingNode == NoNode)
         throw NO_WORKING_NODE_ERR;
 
-    MarkdownNode node(ParagraphMarkdownNodeType, m_workingNode, text);
-    m_workingNode->children().push_back(node);
+    addNode(MarkdownNode(ParagraphMarkdownNodeType, NULL, std::move(text)));
 }
 
 void MarkdownParser::renderHorizontalRule(struct buf* ob, void* opaque)
@@ -241,11 +303,10 @@ void MarkdownParser::renderHorizontalRule(struct buf* ob, void* opaque)
 
 void MarkdownParser::renderHorizontalRule()
 {
-    if (!m_workingNode)
+    if (m_workingNode == NoNode)
         throw NO_WORKING_NODE_ERR;
 
-    MarkdownNode node(HRuleMarkdownNodeType, m_workingNode, ByteBuffer(), MarkdownNode::Data());
-    m_workingNode->children().push_back(node);
+    addNode(MarkdownNode(HRuleMarkdownNodeType, NULL, ByteBuffer(), MarkdownNode::Data()));
 }
 
 void MarkdownParser::renderHTML(struct buf* ob, const struct buf* text, void* opaque)
@@ -257,13 +318,12 @@ void MarkdownParser::renderHTML(struct buf* ob, const struct buf* text, void* op
     p->renderHTML(ByteBufferFromSundown(text));
 }
 
-void MarkdownParser::renderHTML(const ByteBuffer& text)
+void MarkdownParser::renderHTML(ByteBuffer text)
 {
-    if (!m_workingNode)
+    if (m_workingNode == NoNode)
         throw NO_WORKING_NODE_ERR;
 
-    MarkdownNode node(HTMLMarkdownNodeType, m_workingNode, text);
-    m_workingNode->children().push_back(node);
+    addNode(MarkdownNode(HTMLMarkdownNodeType, NULL, std::move(text)));
 }
 
 void MarkdownParser::beginQuote(void* opaque)
@@ -277,14 +337,11 @@ void MarkdownParser::beginQuote(void* opaque)
 
 void MarkdownParser::beginQuote()
 {
-    if (!m_workingNode)
+    if (m_workingNode == NoNode)
         throw NO_WORKING_NODE_ERR;
 
-    MarkdownNode node(QuoteMarkdownNodeType, m_workingNode);
-    m_workingNode->children().push_back(node);
-
     // Push context
-    m_workingNode = &m_workingNode->children().back();
+    m_workingNode = addNode(MarkdownNode(QuoteMarkdownNodeType));
 }
 
 void MarkdownParser::renderQuote(struct buf* ob, const struct buf* text, void* opaque)
@@ -293,21 +350,19 @@ void MarkdownParser::renderQuote(struct buf* ob, const struct buf* text, void* o
         return;
 
     MarkdownParser* p = static_cast<MarkdownParser*>(opaque);
-    p->renderQuote(ByteBufferFromSundown(text));
+    p->renderQuote();
 }
 
-void MarkdownParser::renderQuote(const ByteBuffer& text)
+void MarkdownParser::renderQuote()
 {
-    if (!m_workingNode)
+    if (m_workingNode == NoNode)
         throw NO_WORKING_NODE_ERR;
 
-    if (m_workingNode->type != QuoteMarkdownNodeType)
+    if (m_nodes[m_workingNode].type != QuoteMarkdownNodeType)
         throw WORKING_NODE_MISMATCH_ERR;
 
-    m_workingNode->text = text;
-
     // Pop context
-    m_workingNode = &m_workingNode->parent();
+    m_workingNode = m_links[m_workingNode].parent;
 }
 
 void MarkdownParser::blockDidParse(const src_map* map, const uint8_t* txt_data, size_t size, void* opaque)
@@ -332,13 +387,16 @@ void MarkdownParser::blockDidParse(const BytesRangeSet& sourceMap)
         return;
     }
 
-    if (!m_workingNode)
+    if (m_workingNode == NoNode)
         throw NO_WORKING_NODE_ERR;
 
-    if (m_workingNode->children().empty())
+    size_t lastChild = m_links[m_workingNode].lastChild;
+
+    if (lastChild == NoNode)
         return;
 
-    MarkdownNode& lMarkdownNode = m_workingNode->children().back();
+    MarkdownNode& lMarkdownNode = m_nodes[lastChild];
+    size_t firstGrandchild = m_links[lastChild].firstChild;
 
     // Sundown +1 newline compensation
     //
@@ -361,10 +419,11 @@ void MarkdownParser::blockDidParse(const BytesRangeSet& sourceMap)
 
     // No "inline" list items:
     // Share the list item source map with its artifical node, if exists.
-    if (lMarkdownNode.type == ListItemMarkdownNodeType && !lMarkdownNode.children().empty()
-        && lMarkdownNode.children().front().sourceMap.empty()) {
+    if (lMarkdownNode.type == ListItemMarkdownNodeType && firstGrandchild != NoNode
+        && m_nodes[firstGrandchild].sourceMap.empty()) {
 
-        ByteBuffer& buffer = lMarkdownNode.children().front().text;
+        MarkdownNode& textNode = m_nodes[firstGrandchild];
+        ByteBuffer& buffer = textNode.text;
         ByteBuffer mapped = MapBytesRangeSet(sourceMap, *m_source);
         size_t pos = mapped.find(buffer);
 
@@ -374,9 +433,9 @@ void MarkdownParser::blockDidParse(const BytesRangeSet& sourceMap)
             range.length = buffer.length();
             BytesRangeSet newMap;
             newMap.push_back(range);
-            lMarkdownNode.children().front().sourceMap.append(newMap);
+            textNode.sourceMap.append(newMap);
         } else {
-            lMarkdownNode.children().front().sourceMap.append(sourceMap);
+            textNode.sourceMap.append(sourceMap);
         }
     }
 }
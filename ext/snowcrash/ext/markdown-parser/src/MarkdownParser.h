@@ -44,7 +44,19 @@ namespace mdp
         void parse(const ByteBuffer& source, MarkdownNode& ast);
 
     private:
-        MarkdownNode* m_workingNode;
+        /** Links of a node while the AST is being built */
+        struct NodeLinks {
+            size_t parent;
+            size_t firstChild;
+            size_t lastChild;
+            size_t nextSibling;
+        };
+
+        static const size_t NoNode;
+
+        MarkdownNodeArena m_nodes;
+        std::vector<NodeLinks> m_links;
+        size_t m_workingNode;
         bool m_listBlockContext;
         const ByteBuffer* m_source;
         size_t m_sourceLength;
@@ -53,6 +65,12 @@ namespace mdp
         static const size_t MaxNesting;
         static const int ParserExtensions;
 
+        /** Add node as the last (or first) child of the working node, returns its index */
+        size_t addNode(MarkdownNode&& node, bool first = false);
+
+        /** Lay out built nodes into AST arena */
+        void buildAST(MarkdownNode& ast);
+
         typedef sd_callbacks RenderCallbacks;
         RenderCallbacks renderCallbacks();
 
@@ -61,29 +79,35 @@ namespace mdp
 
         // Header
         static void renderHeader(struct buf* ob, const struct buf* text, int level, void* opaque);
-        void renderHeader(const ByteBuffer& text, int level);
+        void renderHeader(ByteBuffer text, int level);
+
+        // Container blocks (lists, list items and quotes)
+        //
+        // Block callbacks never write any rendered output, the text sundown
+        // passes for a container is at most the inline text of a list item.
+        // It is converted only when the list item needs an artificial paragraph.
 
         // List
         static void beginList(int flags, void* opaque);
         void beginList(int flags);
 
         static void renderList(struct buf* ob, const struct buf* text, int flags, void* opaque);
-        void renderList(const ByteBuffer& text, int flags);
+        void renderList(int flags);
 
         // List item
         static void beginListItem(int flags, void* opaque);
         void beginListItem(int flags);
 
         static void renderListItem(struct buf* ob, const struct buf* text, int flags, void* opaque);
-        void renderListItem(const ByteBuffer& text, int flags);
+        void renderListItem(const struct buf* text, int flags);
 
         // Code block
         static void renderBlockCode(struct buf* ob, const struct buf* text, const struct buf* lang, void* opaque);
-        void renderBlockCode(const ByteBuffer& text, const ByteBuffer& language);
+        void renderBlockCode(ByteBuffer text);
 
         // Paragraph
         static void renderParagraph(struct buf* ob, const struct buf* text, void* opaque);
-        void renderParagraph(const ByteBuffer& text);
+        void renderParagraph(ByteBuffer text);
 
         // Horizontal Rule
         static void renderHorizontalRule(struct buf* ob, void* opaque);
@@ -91,14 +115,14 @@ namespace mdp
 
         // HTML
         static void renderHTML(struct buf* ob, const struct buf* text, void* opaque);
-        void renderHTML(const ByteBuffer& text);
+        void renderHTML(ByteBuffer text);
 
         // Quote
         static void beginQuote(void* opaque);
         void beginQuote();
 
         static void renderQuote(struct buf* ob, const struct buf* text, void* opaque);
-        void renderQuote(const std::string& text);
+        void renderQuote();
 
         // Source maps
         static void blockDidParse(const src_map* map, const uint8_t* txt_data, size_t size, void* opaque);
@@ -180,3 +180,42 @@ TEST_CASE("Byte buffer and Index should return equal char ranges", "[bytebuffer]
     REQUIRE(charMap[4].location == indexMap[4].location);
     REQUIRE(charMap[4].length == indexMap[4].length);
 }
+
+TEST_CASE("Scan ASCII byte buffer", "[bytebuffer]")
+{
+    ByteBuffer src = "# API\n\nSome description of the API\n\tindented\r\n";
+
+    ByteBufferScan scan;
+    ByteBufferCharacterIndex index;
+    mdp::ScanByteBuffer(src, scan, index);
+
+    REQUIRE(scan.ascii);
+    REQUIRE(scan.tab == 35);
+    REQUIRE(scan.carriageReturn == 44);
+
+    REQUIRE(index.size() == src.length());
+    REQUIRE(index[0] == 0);
+    REQUIRE(index[44] == 44);
+}
+
+TEST_CASE("Scan multi-byte byte buffer", "[bytebuffer]")
+{
+    //          bytes:0123456789012345   6   7   8   9   0
+    //          chars:0123456789012345           6   7   8
+    ByteBuffer src = "Some long text: \xe2\x82\xac\t\r";
+
+    ByteBufferScan scan;
+    ByteBufferCharacterIndex index;
+    mdp::ScanByteBuffer(src, scan, index);
+
+    REQUIRE_FALSE(scan.ascii);
+    REQUIRE(scan.tab == 19);
+    REQUIRE(scan.carriageReturn == 20);
+
+    REQUIRE(index.size() == 21);
+    REQUIRE(index[15] == 15);
+    REQUIRE(index[16] == 16);
+    REQUIRE(index[18] == 16);
+    REQUIRE(index[19] == 17);
+    REQUIRE(index[20] == 18);
+}
@@ -0,0 +1,182 @@
+//
+//  test-MarkdownNode.cc
+//  markdownparser
+//
+
+#include "catch.hpp"
+#include "MarkdownParser.h"
+
+using namespace mdp;
+
+TEST_CASE("Append nodes to a collection without arena", "[node]")
+{
+    MarkdownNodes nodes;
+
+    REQUIRE(nodes.empty());
+    REQUIRE(nodes.begin() == nodes.end());
+
+    nodes.push_back(MarkdownNode(ParagraphMarkdownNodeType, NULL, "first"));
+    nodes.push_back(MarkdownNode(ParagraphMarkdownNodeType, NULL, "second"));
+
+    REQUIRE(nodes.size() == 2);
+    REQUIRE(nodes.front().text == "first");
+    REQUIRE(nodes.back().text == "second");
+    REQUIRE(nodes.end() - nodes.begin() == 2);
+    REQUIRE(!nodes.front().hasParent());
+}
+
+TEST_CASE("Appended children point to their parent", "[node]")
+{
+    MarkdownNode root(RootMarkdownNodeType);
+    MarkdownNodeIterator first;
+
+    for (int i = 0; i < 100; ++i) {
+        root.children().push_back(MarkdownNode(ParagraphMarkdownNodeType, &root, "", i));
+
+        if (i == 0) {
+            first = root.children().begin();
+        }
+    }
+
+    REQUIRE(root.children().size() == 100);
+
+    // Iterators address nodes by index, they survive growth of the arena
+    REQUIRE(first == root.children().begin());
+    REQUIRE(first->data == 0);
+
+    int data = 0;
+    for (MarkdownNodeIterator it = root.children().begin(); it != root.children().end(); ++it, ++data) {
+        REQUIRE(it->data == data);
+        REQUIRE(&it->parent() == &root);
+    }
+}
+
+TEST_CASE("Nested children built in separate arena follow their parent", "[node]")
+{
+    MarkdownNode root(RootMarkdownNodeType);
+
+    root.children().push_back(MarkdownNode(ListItemMarkdownNodeType, &root));
+
+    MarkdownNode& item = root.children().front();
+    item.children().push_back(MarkdownNode(ParagraphMarkdownNodeType, &item, "nested"));
+
+    // Grow arena of the root children, the list item moves
+    for (int i = 0; i < 100; ++i) {
+        root.children().push_back(MarkdownNode(ParagraphMarkdownNodeType, &root));
+    }
+
+    const MarkdownNode& moved = root.children().front();
+
+    REQUIRE(moved.type == ListItemMarkdownNodeType);
+    REQUIRE(moved.children().size() == 1);
+    REQUIRE(&moved.children().front().parent() == &moved);
+    REQUIRE(moved.children().front().text == "nested");
+}
+
+TEST_CASE("Children of appended node point to the appended copy", "[node]")
+{
+    MarkdownNode root(RootMarkdownNodeType);
+
+    {
+        MarkdownNode item(ListItemMarkdownNodeType, &root);
+        item.children().push_back(MarkdownNode(ParagraphMarkdownNodeType, &item, "nested"));
+
+        root.children().push_back(item);
+    }
+
+    const MarkdownNode& item = root.children().back();
+
+    REQUIRE(item.children().size() == 1);
+    REQUIRE(&item.children().front().parent() == &item);
+    REQUIRE(&item.parent() == &root);
+}
+
+TEST_CASE("Copies of node share its children", "[node]")
+{
+    MarkdownNode root(RootMarkdownNodeType);
+    root.children().push_back(MarkdownNode(ParagraphMarkdownNodeType, &root, "shared"));
+
+    MarkdownNode copy = root;
+
+    REQUIRE(copy.children().size() == 1);
+    REQUIRE(&copy.children().front() == &root.children().front());
+
+    copy.children().front().text = "changed";
+    REQUIRE(root.children().front().text == "changed");
+
+    // Children keep pointing to the original
+    REQUIRE(&copy.children().front().parent() == &root);
+}
+
+static const ByteBuffer NestedListFixture
+    = "- A\n"
+      "    - B\n"
+      "        - C\n"
+      "    - D\n"
+      "- E\n";
+
+TEST_CASE("Parsed AST is laid out breadth-first", "[node][parser]")
+{
+    MarkdownParser parser;
+    MarkdownNode ast;
+
+    parser.parse(NestedListFixture, ast);
+
+    REQUIRE(!ast.hasParent());
+    REQUIRE(ast.children().size() == 2);
+
+    const MarkdownNode& itemA = ast.children()[0];
+    const MarkdownNode& itemE = ast.children()[1];
+
+    REQUIRE(&itemA.parent() == &ast);
+    REQUIRE(&itemE.parent() == &ast);
+
+    // Siblings are next to each other, their children follow
+    REQUIRE(&itemE == &itemA + 1);
+    REQUIRE(&itemA.children().front() == &itemE + 1);
+    REQUIRE(&itemE.children().front() == &itemA.children().back() + 1);
+
+    REQUIRE(itemA.children().size() == 3);
+
+    for (MarkdownNodeIterator it = itemA.children().begin(); it != itemA.children().end(); ++it) {
+        REQUIRE(&it->parent() == &itemA);
+    }
+
+    const MarkdownNode& itemB = itemA.children()[1];
+    REQUIRE(itemB.children()[0].text == "B");
+    REQUIRE(&itemB.children()[0].parent() == &itemB);
+    REQUIRE(&itemB.parent().parent() == &ast);
+}
+
+TEST_CASE("Appending to parsed AST keeps it consistent", "[node][parser]")
+{
+    MarkdownParser parser;
+    MarkdownNode ast;
+
+    parser.parse(NestedListFixture, ast);
+
+    // Children of item A are not at the end of the arena, they are moved there
+    MarkdownNode& itemA = ast.children()[0];
+    itemA.children().push_back(MarkdownNode(ParagraphMarkdownNodeType, &itemA, "appended"));
+
+    // References into the arena are invalidated, look the item up again
+    const MarkdownNode& item = ast.children()[0];
+
+    REQUIRE(item.children().size() == 4);
+    REQUIRE(item.children()[0].text == "A");
+    REQUIRE(item.children()[1].children()[0].text == "B");
+    REQUIRE(item.children()[1].children()[1].children()[0].text == "C");
+    REQUIRE(item.children()[2].children()[0].text == "D");
+    REQUIRE(item.children()[3].text == "appended");
+
+    for (MarkdownNodeIterator it = item.children().begin(); it != item.children().end(); ++it) {
+        REQUIRE(&it->parent() == &item);
+    }
+
+    const MarkdownNode& itemB = item.children()[1];
+    REQUIRE(&itemB.children()[0].parent() == &itemB);
+
+    REQUIRE(ast.children().size() == 2);
+    REQUIRE(ast.children()[1].children()[0].text == "E");
+    REQUIRE(&ast.children()[1].parent() == &ast);
+}
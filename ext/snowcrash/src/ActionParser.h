@@ -132,6 +132,7 @@ namespace snowcrash
                     checkPayload(sectionType, sourceMap, payload.node, out);
 
                     out.node.examples.back().requests.push_back(payload.node);
+                    recordPendingReference(RequestSectionType, pd, out);
 
                     if (pd.exportSourceMap()) {
                         out.sourceMap.examples.collection.back().requests.collection.push_back(payload.sourceMap);
@@ -160,6 +161,7 @@ namespace snowcrash
                     checkPayload(sectionType, sourceMap, payload.node, out);
 
                     out.node.examples.back().responses.push_back(payload.node);
+                    recordPendingReference(ResponseSectionType, pd, out);
 
                     if (pd.exportSourceMap()) {
                         out.sourceMap.examples.collection.back().responses.collection.push_back(payload.sourceMap);
@@ -207,7 +209,7 @@ namespace snowcrash
                 && !out.node.examples.empty() && !out.node.examples.back().responses.empty()) {
 
                 mdp::ByteBuffer content = CodeBlockUtility::addDanglingAsset(
-                    node, pd, sectionType, out.report, out.node.examples.back().responses.back().body);
+                    node, pd, sectionType, out.report, out.node.examples.back().responses.back().body.buffer());
 
                 if (pd.exportSourceMap() && !content.empty()) {
                     out.sourceMap.examples.collection.back().responses.collection.back().body.sourceMap.append(
@@ -222,7 +224,7 @@ namespace snowcrash
                 && !out.node.examples.empty() && !out.node.examples.back().requests.empty()) {
 
                 mdp::ByteBuffer content = CodeBlockUtility::addDanglingAsset(
-                    node, pd, sectionType, out.report, out.node.examples.back().requests.back().body);
+                    node, pd, sectionType, out.report, out.node.examples.back().requests.back().body.buffer());
 
                 if (pd.exportSourceMap() && !content.empty()) {
                     out.sourceMap.examples.collection.back().requests.collection.back().body.sourceMap.append(
@@ -497,9 +499,7 @@ namespace snowcrash
         {
 
             CaptureGroups captureGroups;
-            mdp::ByteBuffer subject, remaining;
-
-            subject = GetFirstLine(node->text, remaining);
+            mdp::ByteBuffer subject = GetFirstLine(node->text);
             TrimString(subject);
 
             if (RegexCapture(subject, ActionHeaderRegex, captureGroups, 3)) {
@@ -513,18 +513,63 @@ namespace snowcrash
             return;
         }
 
-        /** Finds an action inside an actions collection */
-        static ActionIterator findAction(const Actions& actions, const Action& action)
+        /**
+         *  \brief Record the last added request or response if its model reference is pending
+         *  \param section     `RequestSectionType` or `ResponseSectionType`
+         */
+        static void recordPendingReference(SectionType section, SectionParserData& pd, const ParseResultRef<Action>& out)
+        {
+
+            const TransactionExample& example = out.node.examples.back();
+            const Payload& payload
+                = (section == RequestSectionType) ? example.requests.back() : example.responses.back();
+
+            if (payload.reference.id.empty() || payload.reference.meta.state != Reference::StatePending) {
+                return;
+            }
+
+            PendingReference reference;
+            reference.element = 0;
+            reference.resource = 0;
+            reference.action = 0;
+            reference.example = out.node.examples.size() - 1;
+            reference.section = section;
+            reference.payload
+                = (section == RequestSectionType) ? example.requests.size() - 1 : example.responses.size() - 1;
+
+            pd.pendingReferences.push_back(reference);
+        }
+
+        /** Key of an action in `SectionParserData::actionsIndex`, see `MatchAction` */
+        static std::string actionIndexKey(const Action& action)
+        {
+
+            return action.method + '\n' + action.uriTemplate;
+        }
+
+        /** Checks whether an action with the same method and URI template was already indexed */
+        static bool isActionDuplicate(const Action& action, const SectionParserData& pd)
         {
 
-            return std::find_if(actions.begin(), actions.end(), std::bind2nd(MatchAction(), action));
+            return pd.actionsIndex.find(actionIndexKey(action)) != pd.actionsIndex.end();
         }
 
-        /** Finds a relation identifier inside an actions collection */
-        static ActionIterator findRelation(const Actions& actions, const Relation& relation)
+        /** Checks whether the relation identifier was already indexed, see `MatchRelation` */
+        static bool isRelationDuplicate(const Relation& relation, const SectionParserData& pd)
         {
 
-            return std::find_if(actions.begin(), actions.end(), std::bind2nd(MatchRelation(), relation));
+            return !relation.str.empty() && pd.relationsIndex.find(relation.str) != pd.relationsIndex.end();
+        }
+
+        /** Adds action to the duplicates lookup indexes of its resource */
+        static void indexAction(const Action& action, SectionParserData& pd)
+        {
+
+            pd.actionsIndex.insert(actionIndexKey(action));
+
+            if (!action.relation.str.empty()) {
+                pd.relationsIndex.insert(action.relation.str);
+            }
         }
 
         static void checkForTypoMistake(const MarkdownNodeIterator& node, SectionParserData& pd, Report& report)
@@ -46,7 +46,7 @@ namespace snowcrash
         {
 
             out.node = "";
-            CodeBlockUtility::signatureContentAsCodeBlock(node, pd, out.report, out.node);
+            CodeBlockUtility::signatureContentAsCodeBlock(node, pd, out.report, out.node.buffer());
 
             if (pd.exportSourceMap() && !out.node.empty()) {
                 out.sourceMap.sourceMap.append(node->sourceMap);
@@ -63,12 +63,10 @@ namespace snowcrash
             const ParseResultRef<Asset>& out)
         {
 
-            mdp::ByteBuffer content;
-            CodeBlockUtility::contentAsCodeBlock(node, pd, out.report, content);
+            size_t length = out.node.length();
+            CodeBlockUtility::contentAsCodeBlock(node, pd, out.report, out.node.buffer());
 
-            out.node += content;
-
-            if (pd.exportSourceMap() && !content.empty()) {
+            if (pd.exportSourceMap() && out.node.length() != length) {
                 out.sourceMap.sourceMap.append(node->sourceMap);
             }
 
@@ -107,8 +105,7 @@ namespace snowcrash
         static AssetSignature assetSignature(const MarkdownNodeIterator& node)
         {
 
-            mdp::ByteBuffer remaining, subject = node->children().front().text;
-            subject = GetFirstLine(subject, remaining);
+            mdp::ByteBuffer subject = GetFirstLine(node->children().front().text);
             TrimString(subject);
 
             if (RegexMatch(subject, BodyRegex))
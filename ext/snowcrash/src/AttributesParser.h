@@ -101,9 +101,7 @@ namespace snowcrash
 
             if (node->type == mdp::ListItemMarkdownNodeType && !node->children().empty()) {
 
-                mdp::ByteBuffer remaining, subject = node->children().front().text;
-
-                subject = GetFirstLine(subject, remaining);
+                mdp::ByteBuffer subject = GetFirstLine(node->children().front().text);
                 TrimString(subject);
 
                 if (RegexMatch(subject, AttributesRegex)) {
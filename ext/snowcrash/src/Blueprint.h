@@ -12,6 +12,8 @@
 #include <vector>
 #include <string>
 #include <utility>
+#include <memory>
+#include <ostream>
 #include "Platform.h"
 #include "MarkdownNode.h"
 #include "MSON.h"
@@ -55,8 +57,134 @@ namespace snowcrash
     /** A generic key - value pair */
     typedef std::pair<std::string, std::string> KeyValuePair;
 
-    /** An asset data */
-    typedef std::string Asset;
+    /**
+     *  \brief An asset data
+     *
+     *  Copies of an asset share its text, e.g. the body of a model
+     *  and of every payload referring to the model. The text is
+     *  copied only when a shared asset is modified through `buffer()`.
+     */
+    class Asset
+    {
+    public:
+        Asset() {}
+
+        Asset(const std::string& text) : m_text(text.empty() ? Text() : std::make_shared<std::string>(text)) {}
+
+        Asset(std::string&& text)
+            : m_text(text.empty() ? Text() : std::make_shared<std::string>(std::move(text)))
+        {
+        }
+
+        Asset(const char* text) : m_text(*text ? std::make_shared<std::string>(text) : Text()) {}
+
+        /** Text of the asset */
+        const std::string& str() const
+        {
+            return m_text ? *m_text : EmptyText();
+        }
+
+        operator const std::string&() const
+        {
+            return str();
+        }
+
+        /** Modifiable text of the asset, no longer shared with its copies */
+        std::string& buffer()
+        {
+            if (!m_text) {
+                m_text = std::make_shared<std::string>();
+            } else if (m_text.use_count() > 1) {
+                m_text = std::make_shared<std::string>(*m_text);
+            }
+
+            return *m_text;
+        }
+
+        bool empty() const
+        {
+            return str().empty();
+        }
+
+        size_t length() const
+        {
+            return str().length();
+        }
+
+        size_t size() const
+        {
+            return str().size();
+        }
+
+        const char* c_str() const
+        {
+            return str().c_str();
+        }
+
+        void clear()
+        {
+            m_text.reset();
+        }
+
+        Asset& operator+=(const std::string& text)
+        {
+            if (!text.empty()) {
+                buffer() += text;
+            }
+
+            return *this;
+        }
+
+    private:
+        typedef std::shared_ptr<std::string> Text;
+        Text m_text;
+
+        static const std::string& EmptyText()
+        {
+            static const std::string empty;
+            return empty;
+        }
+    };
+
+    inline bool operator==(const Asset& lhs, const Asset& rhs)
+    {
+        return lhs.str() == rhs.str();
+    }
+
+    inline bool operator==(const Asset& lhs, const std::string& rhs)
+    {
+        return lhs.str() == rhs;
+    }
+
+    inline bool operator==(const std::string& lhs, const Asset& rhs)
+    {
+        return lhs == rhs.str();
+    }
+
+    inline bool operator==(const Asset& lhs, const char* rhs)
+    {
+        return lhs.str() == rhs;
+    }
+
+    inline bool operator!=(const Asset& lhs, const Asset& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    inline bool operator!=(const Asset& lhs, const std::string& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    inline bool operator!=(const Asset& lhs, const char* rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    inline std::ostream& operator<<(std::ostream& os, const Asset& asset)
+    {
+        return os << asset.str();
+    }
 
     /**
      *  \brief Metadata key-value pair,
@@ -11,6 +11,7 @@
 
 #include <iterator>
 #include <algorithm>
+#include <unordered_map>
 #include "ResourceParser.h"
 #include "ResourceGroupParser.h"
 #include "DataStructureGroupParser.h"
@@ -104,9 +105,10 @@ namespace snowcrash
             if (pd.sectionContext() == ResourceGroupSectionType || pd.sectionContext() == ResourceSectionType) {
 
                 IntermediateParseResult<ResourceGroup> resourceGroup(out.report);
+                size_t pendingReferences = pd.pendingReferences.size();
                 cur = ResourceGroupParser::parse(node, siblings, pd, resourceGroup);
 
-                if (isResourceGroupDuplicate(out.node, resourceGroup.node.attributes.name)) {
+                if (!pd.resourceGroupsIndex.insert(resourceGroup.node.attributes.name).second) {
 
                     // WARN: duplicate resource group
                     std::stringstream ss;
@@ -125,6 +127,8 @@ namespace snowcrash
                 }
 
                 out.node.content.elements().push_back(resourceGroup.node);
+                pd.locatePendingReferences(
+                    pendingReferences, &PendingReference::element, out.node.content.elements().size() - 1);
 
                 if (pd.exportSourceMap()) {
                     out.sourceMap.content.elements().collection.push_back(resourceGroup.sourceMap);
@@ -553,22 +557,20 @@ namespace snowcrash
 
             if (lines.size() == out.node.size()) {
 
-                // Check duplicates
-                std::vector<mdp::ByteBuffer> duplicateKeys;
+                // Check duplicates, warn once per key in order of first definitions
+                std::unordered_map<mdp::ByteBuffer, size_t> keyCounts;
 
                 for (MetadataCollectionIterator it = out.node.begin(); it != out.node.end(); ++it) {
+                    ++keyCounts[it->first];
+                }
 
-                    MetadataCollectionIterator from = it;
-                    if (++from == out.node.end())
-                        break;
+                for (MetadataCollectionIterator it = out.node.begin(); it != out.node.end(); ++it) {
 
-                    MetadataCollectionIterator duplicate
-                        = std::find_if(from, out.node.end(), std::bind2nd(MatchFirsts<Metadata>(), *it));
+                    size_t& count = keyCounts[it->first];
 
-                    if (duplicate != out.node.end()
-                        && std::find(duplicateKeys.begin(), duplicateKeys.end(), it->first) == duplicateKeys.end()) {
+                    if (count > 1) {
 
-                        duplicateKeys.push_back(it->first);
+                        count = 0;
 
                         // WARN: duplicate metadata definition
                         std::stringstream ss;
@@ -592,217 +594,58 @@ namespace snowcrash
         }
 
         /**
-         * \brief Check if a resource group already exists with the given name
-         *
-         * \param blueprint The blueprint which is formed until now
-         * \param name The resource group name to be checked
-         */
-        static bool isResourceGroupDuplicate(const Blueprint& blueprint, mdp::ByteBuffer& name)
-        {
-
-            for (Elements::const_iterator it = blueprint.content.elements().begin();
-                 it != blueprint.content.elements().end();
-                 ++it) {
-
-                if (it->element == Element::CategoryElement && it->category == Element::ResourceGroupCategory
-                    && it->attributes.name == name) {
-
-                    return true;
-                }
-            }
-
-            return false;
-        }
-
-        /**
-         *  \brief  Checks both blueprint and source map AST to resolve references with `Pending` state (Lazy
-         * referencing)
+         *  \brief  Resolve references with `Pending` state (Lazy referencing) recorded while parsing
          *  \param  pd       Section parser state
          *  \param  out      Processed output
          */
         static void checkLazyReferencing(SectionParserData& pd, const ParseResultRef<Blueprint>& out)
         {
 
-            Collection<SourceMap<Element> >::iterator elementSourceMapIt;
-
-            if (pd.exportSourceMap()) {
-                elementSourceMapIt = out.sourceMap.content.elements().collection.begin();
-            }
+            for (PendingReferences::const_iterator it = pd.pendingReferences.begin();
+                 it != pd.pendingReferences.end();
+                 ++it) {
 
-            for (Elements::iterator elementIt = out.node.content.elements().begin();
-                 elementIt != out.node.content.elements().end();
-                 ++elementIt) {
+                TransactionExample& example = out.node.content.elements()[it->element]
+                                                  .content.elements()[it->resource]
+                                                  .content.resource.actions[it->action]
+                                                  .examples[it->example];
 
-                if (elementIt->element == Element::CategoryElement) {
-                    checkResourceLazyReferencing(*elementIt, elementSourceMapIt, pd, out);
-                }
+                Payload& payload = (it->section == RequestSectionType) ? example.requests[it->payload]
+                                                                        : example.responses[it->payload];
 
-                if (pd.exportSourceMap()) {
-                    elementSourceMapIt++;
+                if (payload.reference.id.empty() || payload.reference.meta.state != Reference::StatePending) {
+                    continue;
                 }
-            }
-        }
-
-        /** Traverses Resource Collection to resolve references with `Pending` state (Lazy referencing) */
-        static void checkResourceLazyReferencing(Element& element,
-            Collection<SourceMap<Element> >::iterator& elementSourceMap,
-            SectionParserData& pd,
-            const ParseResultRef<Blueprint>& out)
-        {
 
-            Collection<SourceMap<Element> >::iterator resourceElementSourceMapIt;
-
-            if (pd.exportSourceMap()) {
-                resourceElementSourceMapIt = elementSourceMap->content.elements().collection.begin();
-            }
-
-            for (Elements::iterator resourceElementIt = element.content.elements().begin();
-                 resourceElementIt != element.content.elements().end();
-                 ++resourceElementIt) {
-
-                if (resourceElementIt->element == Element::ResourceElement) {
-                    if (pd.exportSourceMap()) {
-                        checkActionLazyReferencing(
-                            resourceElementIt->content.resource, resourceElementSourceMapIt->content.resource, pd, out);
-                    } else {
-                        SourceMap<Resource> tempSourceMap;
-                        checkActionLazyReferencing(resourceElementIt->content.resource, tempSourceMap, pd, out);
-                    }
-                }
+                SourceMap<Payload> tempSourceMap;
+                SourceMap<Payload>* payloadSourceMap = &tempSourceMap;
 
                 if (pd.exportSourceMap()) {
-                    resourceElementSourceMapIt++;
-                }
-            }
-        }
 
-        /** Traverses Action Collection to resolve references with `Pending` state (Lazy referencing) */
-        static void checkActionLazyReferencing(Resource& resource,
-            SourceMap<Resource>& resourceSourceMap,
-            SectionParserData& pd,
-            const ParseResultRef<Blueprint>& out)
-        {
-
-            Collection<SourceMap<Action> >::iterator actionSourceMapIt;
-
-            if (pd.exportSourceMap()) {
-                actionSourceMapIt = resourceSourceMap.actions.collection.begin();
-            }
-
-            for (Actions::iterator actionIt = resource.actions.begin(); actionIt != resource.actions.end();
-                 ++actionIt) {
-
-                checkExampleLazyReferencing(*actionIt, actionSourceMapIt, pd, out);
-
-                if (pd.exportSourceMap()) {
-                    actionSourceMapIt++;
+                    SourceMap<TransactionExample>& exampleSourceMap
+                        = out.sourceMap.content.elements()
+                              .collection[it->element]
+                              .content.elements()
+                              .collection[it->resource]
+                              .content.resource.actions.collection[it->action]
+                              .examples.collection[it->example];
+
+                    payloadSourceMap = (it->section == RequestSectionType)
+                        ? &exampleSourceMap.requests.collection[it->payload]
+                        : &exampleSourceMap.responses.collection[it->payload];
                 }
-            }
-        }
 
-        /** Traverses Transaction Example Collection AST to resolve references with `Pending` state (Lazy referencing)
-         */
-        static void checkExampleLazyReferencing(Action& action,
-            Collection<SourceMap<Action> >::iterator& actionSourceMapIt,
-            SectionParserData& pd,
-            const ParseResultRef<Blueprint>& out)
-        {
-
-            Collection<SourceMap<TransactionExample> >::iterator exampleSourceMapIt;
-
-            if (pd.exportSourceMap()) {
-                exampleSourceMapIt = actionSourceMapIt->examples.collection.begin();
-            }
-
-            for (TransactionExamples::iterator transactionExampleIt = action.examples.begin();
-                 transactionExampleIt != action.examples.end();
-                 ++transactionExampleIt) {
-
-                checkRequestLazyReferencing(*transactionExampleIt, exampleSourceMapIt, pd, out);
-                checkResponseLazyReferencing(*transactionExampleIt, exampleSourceMapIt, pd, out);
-
-                if (pd.exportSourceMap()) {
-                    exampleSourceMapIt++;
-                }
-            }
-        }
-
-        /** Traverses Request Collection to resolve references with `Pending` state (Lazy referencing) */
-        static void checkRequestLazyReferencing(TransactionExample& transactionExample,
-            Collection<SourceMap<TransactionExample> >::iterator& transactionExampleSourceMapIt,
-            SectionParserData& pd,
-            const ParseResultRef<Blueprint>& out)
-        {
-
-            Collection<SourceMap<Request> >::iterator requestSourceMapIt;
-
-            if (pd.exportSourceMap()) {
-                requestSourceMapIt = transactionExampleSourceMapIt->requests.collection.begin();
-            }
-
-            for (Requests::iterator requestIt = transactionExample.requests.begin();
-                 requestIt != transactionExample.requests.end();
-                 ++requestIt) {
-
-                if (!requestIt->reference.id.empty() && requestIt->reference.meta.state == Reference::StatePending) {
-
-                    if (pd.exportSourceMap()) {
-
-                        ParseResultRef<Payload> payload(out.report, *requestIt, *requestSourceMapIt);
-                        resolvePendingModels(pd, payload);
-                        SectionProcessor<Payload>::checkRequest(requestIt->reference.meta.node, pd, payload);
-                    } else {
+                ParseResultRef<Payload> result(out.report, payload, *payloadSourceMap);
+                resolvePendingModels(pd, result);
 
-                        SourceMap<Payload> tempSourceMap;
-                        ParseResultRef<Payload> payload(out.report, *requestIt, tempSourceMap);
-                        resolvePendingModels(pd, payload);
-                        SectionProcessor<Payload>::checkRequest(requestIt->reference.meta.node, pd, payload);
-                    }
-                }
-
-                if (pd.exportSourceMap()) {
-                    requestSourceMapIt++;
+                if (it->section == RequestSectionType) {
+                    SectionProcessor<Payload>::checkRequest(payload.reference.meta.node, pd, result);
+                } else {
+                    SectionProcessor<Payload>::checkResponse(payload.reference.meta.node, pd, result);
                 }
             }
-        }
-
-        /** Traverses Response Collection to resolve references with `Pending` state (Lazy referencing) */
-        static void checkResponseLazyReferencing(TransactionExample& transactionExample,
-            Collection<SourceMap<TransactionExample> >::iterator& transactionExampleSourceMapIt,
-            SectionParserData& pd,
-            const ParseResultRef<Blueprint>& out)
-        {
-
-            Collection<SourceMap<Response> >::iterator responseSourceMapIt;
-
-            if (pd.exportSourceMap()) {
-                responseSourceMapIt = transactionExampleSourceMapIt->responses.collection.begin();
-            }
-
-            for (Responses::iterator responseIt = transactionExample.responses.begin();
-                 responseIt != transactionExample.responses.end();
-                 ++responseIt) {
-
-                if (!responseIt->reference.id.empty() && responseIt->reference.meta.state == Reference::StatePending) {
-
-                    if (pd.exportSourceMap()) {
-
-                        ParseResultRef<Payload> payload(out.report, *responseIt, *responseSourceMapIt);
-                        resolvePendingModels(pd, payload);
-                        SectionProcessor<Payload>::checkResponse(responseIt->reference.meta.node, pd, payload);
-                    } else {
 
-                        SourceMap<Payload> tempSourceMap;
-                        ParseResultRef<Payload> payload(out.report, *responseIt, tempSourceMap);
-                        resolvePendingModels(pd, payload);
-                        SectionProcessor<Payload>::checkResponse(responseIt->reference.meta.node, pd, payload);
-                    }
-                }
-
-                if (pd.exportSourceMap()) {
-                    responseSourceMapIt++;
-                }
-            }
+            pd.pendingReferences.clear();
         }
 
         /**
@@ -122,8 +122,7 @@ namespace snowcrash
         {
 
             // Check for possible superfluous indentation of a recognized list items.
-            mdp::ByteBuffer r;
-            mdp::ByteBuffer line = GetFirstLine(node->text, r);
+            mdp::ByteBuffer line = GetFirstLine(node->text);
             TrimString(line);
 
             // If line appears to be a Markdown list.
@@ -238,10 +237,16 @@ namespace snowcrash
             const MarkdownNodeIterator& node, const SectionParserData& pd, Report& report)
         {
 
-            mdp::ByteBuffer source = node->text;
-            Identifier symbol;
+            // Reference is a single `[<identifier>][]`, avoid copying any other content
+            const mdp::ByteBuffer& text = node->text;
+            mdp::ByteBuffer::size_type first = text.find_first_not_of(" \t\n\v\f\r");
+            mdp::ByteBuffer::size_type last = text.find_last_not_of(" \t\n\v\f\r");
+
+            if (first == mdp::ByteBuffer::npos || text[first] != '[' || text[last] != ']')
+                return false;
 
-            TrimString(source);
+            mdp::ByteBuffer source = text.substr(first, last - first + 1);
+            Identifier symbol;
 
             if (GetModelReference(source, symbol)) {
 
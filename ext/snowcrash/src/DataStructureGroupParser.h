@@ -91,9 +91,7 @@ namespace snowcrash
 
             if (node->type == mdp::HeaderMarkdownNodeType && !node->text.empty()) {
 
-                mdp::ByteBuffer remaining, subject = node->text;
-
-                subject = GetFirstLine(subject, remaining);
+                mdp::ByteBuffer subject = GetFirstLine(node->text);
                 TrimString(subject);
 
                 if (RegexMatch(subject, DataStructureGroupRegex)) {
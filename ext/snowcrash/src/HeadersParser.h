@@ -158,11 +158,7 @@ namespace snowcrash
 
             if (node->type == mdp::ListItemMarkdownNodeType && !node->children().empty()) {
 
-                mdp::ByteBuffer subject = node->children().front().text;
-                mdp::ByteBuffer signature;
-                mdp::ByteBuffer remainingContent;
-
-                signature = GetFirstLine(subject, remainingContent);
+                mdp::ByteBuffer signature = GetFirstLine(node->children().front().text);
                 TrimString(signature);
 
                 if (RegexMatch(signature, HeadersRegex))
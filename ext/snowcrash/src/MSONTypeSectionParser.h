@@ -163,17 +163,16 @@ namespace snowcrash
         static SectionType sectionType(const MarkdownNodeIterator& node)
         {
 
-            mdp::ByteBuffer subject, remaining;
+            mdp::ByteBuffer subject;
 
             if (node->type == mdp::HeaderMarkdownNodeType && !node->text.empty()) {
 
-                subject = node->text;
+                subject = GetFirstLine(node->text);
             } else if (node->type == mdp::ListItemMarkdownNodeType && !node->children().empty()) {
 
-                subject = node->children().front().text;
+                subject = GetFirstLine(node->children().front().text);
             }
 
-            subject = GetFirstLine(subject, remaining);
             TrimString(subject);
 
             if (RegexMatch(subject, MSONDefaultTypeSectionRegex) || RegexMatch(subject, MSONSampleTypeSectionRegex)) {
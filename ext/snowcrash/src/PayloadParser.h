@@ -88,8 +88,8 @@ namespace snowcrash
                     // NOTE: NOT THE CORRECT WAY TO DO THIS
                     // https://github.com/apiaryio/snowcrash/commit/a7c5868e62df0048a85e2f9aeeb42c3b3e0a2f07#commitcomment-7322085
                     pd.sectionsContext.push_back(BodySectionType);
-                    CodeBlockUtility::signatureContentAsCodeBlock(node, pd, out.report, out.node.body);
-                    TwoNewLines(out.node.body);
+                    CodeBlockUtility::signatureContentAsCodeBlock(node, pd, out.report, out.node.body.buffer());
+                    TwoNewLines(out.node.body.buffer());
                     pd.sectionsContext.pop_back();
 
                     if (pd.exportSourceMap() && !out.node.body.empty()) {
@@ -227,7 +227,7 @@ namespace snowcrash
                 && sectionType == BodySectionType) {
 
                 mdp::ByteBuffer content
-                    = CodeBlockUtility::addDanglingAsset(node, pd, sectionType, out.report, out.node.body);
+                    = CodeBlockUtility::addDanglingAsset(node, pd, sectionType, out.report, out.node.body.buffer());
 
                 if (pd.exportSourceMap() && !content.empty()) {
                     out.sourceMap.body.sourceMap.append(node->sourceMap);
@@ -344,11 +344,7 @@ namespace snowcrash
         static PayloadSignature payloadSignature(const MarkdownNodeIterator& node)
         {
 
-            mdp::ByteBuffer subject = node->children().front().text;
-            mdp::ByteBuffer signature;
-            mdp::ByteBuffer remainingContent;
-
-            signature = GetFirstLine(subject, remainingContent);
+            mdp::ByteBuffer signature = GetFirstLine(node->children().front().text);
             TrimString(signature);
 
             if (RegexMatch(signature, RequestRegex))
@@ -552,8 +548,7 @@ namespace snowcrash
         static void assingReferredPayload(SectionParserData& pd, const ParseResultRef<Payload>& out)
         {
 
-            SourceMap<ResourceModel> modelSM;
-            ResourceModel model = pd.modelTable.find(out.node.reference.id)->second;
+            const ResourceModel& model = pd.modelTable.find(out.node.reference.id)->second;
 
             out.node.description = model.description;
             out.node.parameters = model.parameters;
@@ -589,7 +584,7 @@ namespace snowcrash
 
             if (pd.exportSourceMap()) {
 
-                modelSM = pd.modelSourceMapTable.at(out.node.reference.id);
+                const SourceMap<ResourceModel>& modelSM = pd.modelSourceMapTable.at(out.node.reference.id);
 
                 out.sourceMap.description = modelSM.description;
                 out.sourceMap.parameters = modelSM.parameters;
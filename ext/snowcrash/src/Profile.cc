@@ -0,0 +1,389 @@
+//
+//  Profile.cc
+//  snowcrash
+//
+
+#include "Profile.h"
+
+#if defined(TRACK_ALLOCATIONS)
+#include <cstdlib>
+#include <new>
+#endif
+
+using namespace snowcrash;
+
+static thread_local Profile* CurrentProfile = NULL;
+
+// Set while the profile itself is allocating its records
+static thread_local bool ProfileSuspended = false;
+
+namespace
+{
+    /**
+     *  \brief Excludes allocations of profile records from the profile
+     */
+    struct SuspendProfile {
+        bool suspended;
+
+        SuspendProfile() : suspended(ProfileSuspended)
+        {
+            ProfileSuspended = true;
+        }
+
+        ~SuspendProfile()
+        {
+            ProfileSuspended = suspended;
+        }
+    };
+}
+
+#if defined(TRACK_ALLOCATIONS)
+
+void* operator new(std::size_t size)
+{
+    if (CurrentProfile && !ProfileSuspended)
+        CurrentProfile->allocated(size);
+
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    if (CurrentProfile && !ProfileSuspended)
+        CurrentProfile->allocated(size);
+
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+    return ::operator new(size, tag);
+}
+
+void operator delete(void* p) noexcept
+{
+    if (p && CurrentProfile && !ProfileSuspended)
+        CurrentProfile->deallocated();
+
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    ::operator delete(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    ::operator delete(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    ::operator delete(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+    ::operator delete(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+    ::operator delete(p);
+}
+
+#endif
+
+/**
+ *  \brief Write string as JSON string literal
+ */
+static void WriteJSONString(std::ostream& os, const std::string& str)
+{
+    static const char* const HexDigits = "0123456789abcdef";
+
+    os << '"';
+
+    for (std::string::const_iterator it = str.begin(); it != str.end(); ++it) {
+        unsigned char c = static_cast<unsigned char>(*it);
+
+        switch (c) {
+            case '"':
+                os << "\\\"";
+                break;
+            case '\\':
+                os << "\\\\";
+                break;
+            case '\n':
+                os << "\\n";
+                break;
+            default:
+                if (c < 0x20) {
+                    os << "\\u00" << HexDigits[c >> 4] << HexDigits[c & 0xf];
+                } else {
+                    os << *it;
+                }
+        }
+    }
+
+    os << '"';
+}
+
+/**
+ *  \brief Write duration in microseconds as used by trace event format
+ */
+static void WriteMicroseconds(std::ostream& os, const std::chrono::nanoseconds& duration)
+{
+    long long ns = duration.count();
+    long long fraction = ns % 1000;
+
+    os << ns / 1000 << '.' << (fraction / 100) << (fraction / 10 % 10) << (fraction % 10);
+}
+
+Profile::Profile() : tracingEnabled(false), origin(Clock::now())
+{
+    for (size_t i = 0; i < ProfileStageCount; ++i) {
+        active[i] = 0;
+    }
+}
+
+const StageStatistics& Profile::stage(ProfileStage stage) const
+{
+    return stages[stage];
+}
+
+void Profile::enter(ProfileStage stage)
+{
+    SuspendProfile suspend;
+
+    Frame frame = { stage, Clock::now(), Clock::duration::zero() };
+    frames.push_back(frame);
+
+    ++active[stage];
+    ++stages[stage].calls;
+
+    if (tracingEnabled) {
+        beginSpan("stage", name(stage), mdp::BytesRangeSet());
+    }
+}
+
+void Profile::leave()
+{
+    if (frames.empty())
+        return;
+
+    SuspendProfile suspend;
+
+    Frame frame = frames.back();
+    frames.pop_back();
+
+    if (tracingEnabled) {
+        endSpan();
+    }
+
+    Clock::duration elapsed = Clock::now() - frame.start;
+    StageStatistics& statistics = stages[frame.stage];
+
+    statistics.self += std::chrono::duration<double>(elapsed - frame.nested).count();
+
+    // Count recursively entered stage only once
+    if (--active[frame.stage] == 0) {
+        statistics.total += std::chrono::duration<double>(elapsed).count();
+    }
+
+    if (!frames.empty()) {
+        frames.back().nested += elapsed;
+    }
+}
+
+void Profile::allocated(size_t size)
+{
+    if (frames.empty())
+        return;
+
+    StageStatistics& statistics = stages[frames.back().stage];
+
+    ++statistics.allocations;
+    statistics.bytes += size;
+}
+
+void Profile::deallocated()
+{
+    if (frames.empty())
+        return;
+
+    ++stages[frames.back().stage].deallocations;
+}
+
+bool Profile::tracksAllocations()
+{
+#if defined(TRACK_ALLOCATIONS)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Profile::trace(bool enabled)
+{
+    tracingEnabled = enabled;
+}
+
+bool Profile::tracing() const
+{
+    return tracingEnabled;
+}
+
+void Profile::beginSpan(const char* category, const std::string& name, const mdp::BytesRangeSet& sourceMap)
+{
+    SuspendProfile suspend;
+
+    TraceEvent event;
+    event.name = name;
+    event.category = category;
+    event.start = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - origin);
+    event.duration = std::chrono::nanoseconds::zero();
+    event.sourceMap = sourceMap;
+    event.thread = 0;
+
+    openSpans.push_back(traceEvents.size());
+    traceEvents.push_back(event);
+}
+
+void Profile::endSpan()
+{
+    if (openSpans.empty())
+        return;
+
+    TraceEvent& event = traceEvents[openSpans.back()];
+    openSpans.pop_back();
+
+    event.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - origin) - event.start;
+}
+
+const std::vector<TraceEvent>& Profile::events() const
+{
+    return traceEvents;
+}
+
+void Profile::merge(const Profile& worker, unsigned thread)
+{
+    SuspendProfile suspend;
+
+    for (size_t i = 0; i < ProfileStageCount; ++i) {
+        StageStatistics& statistics = stages[i];
+        const StageStatistics& recorded = worker.stages[i];
+
+        statistics.total += recorded.total;
+        statistics.self += recorded.self;
+        statistics.calls += recorded.calls;
+        statistics.allocations += recorded.allocations;
+        statistics.deallocations += recorded.deallocations;
+        statistics.bytes += recorded.bytes;
+    }
+
+    // worker events are relative to beginning of its profile
+    std::chrono::nanoseconds offset = std::chrono::duration_cast<std::chrono::nanoseconds>(worker.origin - origin);
+
+    for (std::vector<TraceEvent>::const_iterator it = worker.traceEvents.begin(); it != worker.traceEvents.end();
+         ++it) {
+        TraceEvent event = *it;
+        event.start += offset;
+        event.thread = thread;
+
+        traceEvents.push_back(event);
+    }
+}
+
+void Profile::writeTrace(std::ostream& os) const
+{
+    SuspendProfile suspend;
+
+    os << "{\"traceEvents\":[";
+
+    for (std::vector<TraceEvent>::const_iterator it = traceEvents.begin(); it != traceEvents.end(); ++it) {
+        if (it != traceEvents.begin())
+            os << ",";
+
+        os << "\n{\"name\":";
+        WriteJSONString(os, it->name);
+        os << ",\"cat\":";
+        WriteJSONString(os, it->category);
+        os << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << it->thread + 1 << ",\"ts\":";
+        WriteMicroseconds(os, it->start);
+        os << ",\"dur\":";
+        WriteMicroseconds(os, it->duration);
+
+        if (!it->sourceMap.empty()) {
+            os << ",\"args\":{\"sourceMap\":[";
+
+            for (mdp::BytesRangeSet::const_iterator range = it->sourceMap.begin(); range != it->sourceMap.end();
+                 ++range) {
+                if (range != it->sourceMap.begin())
+                    os << ",";
+
+                os << "[" << range->location << "," << range->length << "]";
+            }
+
+            os << "]}";
+        }
+
+        os << "}";
+    }
+
+    os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+Profile* Profile::current()
+{
+    return CurrentProfile;
+}
+
+void Profile::current(Profile* profile)
+{
+    CurrentProfile = profile;
+}
+
+const char* Profile::name(ProfileStage stage)
+{
+    switch (stage) {
+        case MarkdownParseStage:
+            return "markdown";
+        case BlueprintParseStage:
+            return "blueprint";
+        case NamedTypesStage:
+            return "named types";
+        case RefractStage:
+            return "refract";
+        case RenderBodyStage:
+            return "render body";
+        case RenderSchemaStage:
+            return "render schema";
+        case ExpandStage:
+            return "expand";
+        case SerializeStage:
+            return "serialize";
+        case ReportStage:
+            return "report";
+        default:
+            return "unknown";
+    }
+}
+
+ProfileSession::ProfileSession(Profile* profile) : previous(Profile::current())
+{
+    Profile::current(profile);
+}
+
+ProfileSession::~ProfileSession()
+{
+    Profile::current(previous);
+}
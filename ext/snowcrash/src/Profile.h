@@ -0,0 +1,236 @@
+//
+//  Profile.h
+//  snowcrash
+//
+
+#ifndef SNOWCRASH_PROFILE_H
+#define SNOWCRASH_PROFILE_H
+
+#include <chrono>
+#include <vector>
+#include <string>
+#include <ostream>
+#include <cstddef>
+
+#include "ByteBuffer.h"
+
+namespace snowcrash
+{
+
+    /**
+     *  \brief Pipeline stages recorded by the profiler
+     *
+     *  Markdown and blueprint stages are recorded by snowcrash itself,
+     *  the rest of them by its consumers (drafter) as they convert,
+     *  render and serialize the parse result.
+     */
+    enum ProfileStage
+    {
+        MarkdownParseStage = 0, /// < Markdown AST, `MarkdownParser::parse`
+        BlueprintParseStage,    /// < Section parsing, `BlueprintParser::parse`
+        NamedTypesStage,        /// < Named types registration
+        RefractStage,           /// < AST to refract conversion
+        RenderBodyStage,        /// < Message body rendering
+        RenderSchemaStage,      /// < Message body schema rendering
+        ExpandStage,            /// < MSON named types expansion
+        SerializeStage,         /// < Parse result serialization
+        ReportStage,            /// < Annotations reporting
+        ProfileStageCount
+    };
+
+    /**
+     *  \brief Statistics collected for one pipeline stage
+     */
+    struct StageStatistics {
+        double total;         /// < Wall time spent in the stage including nested stages (s)
+        double self;          /// < Wall time spent in the stage itself (s)
+        size_t calls;         /// < Number of times the stage was entered
+        size_t allocations;   /// < Number of allocations done by the stage itself
+        size_t deallocations; /// < Number of deallocations done by the stage itself
+        size_t bytes;         /// < Number of bytes allocated by the stage itself
+
+        StageStatistics() : total(0), self(0), calls(0), allocations(0), deallocations(0), bytes(0) {}
+    };
+
+    /**
+     *  \brief Span recorded in trace of a parse run
+     */
+    struct TraceEvent {
+        std::string name;                  /// < Name of the span (stage, URI template, type name...)
+        const char* category;              /// < Category of the span (stage, resource, action...)
+        std::chrono::nanoseconds start;    /// < Start of the span since beginning of the profile
+        std::chrono::nanoseconds duration; /// < Duration of the span
+        mdp::BytesRangeSet sourceMap;      /// < Source data the span is processing
+        unsigned thread;                   /// < Thread the span was recorded on, 0 for the profiling one
+    };
+
+    /**
+     *  \brief Per-stage wall time and allocation profile of a parse run
+     *
+     *  Stages nest - the time a stage spends in a nested stage is
+     *  accounted to the nested one only in `self` but to both in `total`.
+     */
+    class Profile
+    {
+    public:
+        typedef std::chrono::steady_clock Clock;
+
+        Profile();
+
+        /** \brief Statistics of given stage */
+        const StageStatistics& stage(ProfileStage stage) const;
+
+        /** \brief Record entering the stage */
+        void enter(ProfileStage stage);
+
+        /** \brief Record leaving the most recently entered stage */
+        void leave();
+
+        /** \brief Attribute an allocation to the innermost active stage */
+        void allocated(size_t size);
+
+        /** \brief Attribute a deallocation to the innermost active stage */
+        void deallocated();
+
+        /**
+         *  \brief True if allocations are counted
+         *
+         *  Allocations are counted only if built with `TRACK_ALLOCATIONS`
+         *  (`./configure --track-allocations`), which replaces global
+         *  `operator new` and `operator delete`.
+         */
+        static bool tracksAllocations();
+
+        /** \brief Enable or disable recording of trace events */
+        void trace(bool enabled);
+
+        /** \brief True if trace events are recorded */
+        bool tracing() const;
+
+        /** \brief Record beginning of trace span */
+        void beginSpan(const char* category, const std::string& name, const mdp::BytesRangeSet& sourceMap);
+
+        /** \brief Record end of the most recently begun trace span */
+        void endSpan();
+
+        /** \brief Recorded trace events */
+        const std::vector<TraceEvent>& events() const;
+
+        /**
+         *  \brief Add profile recorded on worker thread to this one
+         *
+         *  Statistics of stages are summed, so time of a stage is the time
+         *  spent in it by all the threads. Trace events are added as
+         *  recorded on `thread`.
+         *
+         *  \param worker  Profile recorded on worker thread
+         *  \param thread  Number of the worker thread, greater than 0
+         */
+        void merge(const Profile& worker, unsigned thread);
+
+        /**
+         *  \brief Write recorded trace events in Chrome `trace_event` JSON format
+         *  \param os  Stream to write into
+         */
+        void writeTrace(std::ostream& os) const;
+
+        /** \brief Profile recording on the current thread, NULL if none */
+        static Profile* current();
+
+        /** \brief Human readable name of stage */
+        static const char* name(ProfileStage stage);
+
+    private:
+        struct Frame {
+            ProfileStage stage;
+            Clock::time_point start;
+            Clock::duration nested;
+        };
+
+        StageStatistics stages[ProfileStageCount];
+        size_t active[ProfileStageCount];
+        std::vector<Frame> frames;
+
+        bool tracingEnabled;
+        Clock::time_point origin;
+        std::vector<TraceEvent> traceEvents;
+        std::vector<size_t> openSpans;
+
+        friend class ProfileSession;
+        static void current(Profile* profile);
+    };
+
+    /**
+     *  \brief Makes profile the recording one for the current thread
+     *  while in scope. NULL profile disables recording.
+     */
+    class ProfileSession
+    {
+        Profile* previous;
+
+        ProfileSession(const ProfileSession&);
+        ProfileSession& operator=(const ProfileSession&);
+
+    public:
+        explicit ProfileSession(Profile* profile);
+        ~ProfileSession();
+    };
+
+    /**
+     *  \brief Records a stage into the current thread profile while in scope
+     *
+     *  Does nothing if no profile is recording on the current thread.
+     */
+    class ProfileScope
+    {
+        Profile* profile;
+
+        ProfileScope(const ProfileScope&);
+        ProfileScope& operator=(const ProfileScope&);
+
+    public:
+        explicit ProfileScope(ProfileStage stage) : profile(Profile::current())
+        {
+            if (profile)
+                profile->enter(stage);
+        }
+
+        ~ProfileScope()
+        {
+            if (profile)
+                profile->leave();
+        }
+    };
+
+    /**
+     *  \brief Records a trace span into the current thread profile while in scope
+     *
+     *  Does nothing unless the current thread profile records trace events.
+     */
+    class TraceScope
+    {
+        Profile* profile;
+
+        TraceScope(const TraceScope&);
+        TraceScope& operator=(const TraceScope&);
+
+    public:
+        TraceScope(const char* category, const std::string& name, const mdp::BytesRangeSet& sourceMap)
+            : profile(Profile::current())
+        {
+            if (profile && !profile->tracing())
+                profile = NULL;
+
+            if (profile)
+                profile->beginSpan(category, name, sourceMap);
+        }
+
+        ~TraceScope()
+        {
+            if (profile)
+                profile->endSpan();
+        }
+    };
+}
+
+#endif
@@ -108,17 +108,13 @@ namespace snowcrash
             if (pd.sectionContext() == ResourceSectionType) {
 
                 IntermediateParseResult<Resource> resource(out.report);
+                size_t pendingReferences = pd.pendingReferences.size();
                 cur = ResourceParser::parse(node, siblings, pd, resource);
 
-                bool duplicate = SectionProcessor<Resource>::isResourceDuplicate(
-                    out.node.content.elements(), resource.node.uriTemplate);
-                bool globalDuplicate;
+                // Resources of this and all preceding groups
+                bool duplicate = !pd.resourcesIndex.insert(resource.node.uriTemplate).second;
 
-                if (!duplicate) {
-                    globalDuplicate = isResourceDuplicate(pd.blueprint, resource.node.uriTemplate);
-                }
-
-                if (duplicate || globalDuplicate) {
+                if (duplicate) {
 
                     // WARN: Duplicate resource
                     mdp::CharactersRangeSet sourceMap
@@ -133,6 +129,8 @@ namespace snowcrash
                 resourceElement.content.resource = resource.node;
 
                 out.node.content.elements().push_back(resourceElement);
+                pd.locatePendingReferences(
+                    pendingReferences, &PendingReference::resource, out.node.content.elements().size() - 1);
 
                 if (pd.exportSourceMap()) {
 
@@ -240,29 +238,6 @@ namespace snowcrash
             return SectionProcessorBase<ResourceGroup>::isUnexpectedNode(node, sectionType);
         }
 
-        /**
-         * \brief Given a blueprint, Check if a resource already exists with the given uri template
-         *
-         * \param blueprint The blueprint which is formed until now
-         * \param uri The resource uri template to be checked
-         */
-        static bool isResourceDuplicate(const Blueprint& blueprint, const URITemplate& uri)
-        {
-
-            for (Elements::const_iterator it = blueprint.content.elements().begin();
-                 it != blueprint.content.elements().end();
-                 ++it) {
-
-                if (it->element == Element::CategoryElement
-                    && SectionProcessor<Resource>::isResourceDuplicate(it->content.elements(), uri)) {
-
-                    return true;
-                }
-            }
-
-            return false;
-        }
-
         /**
          * \brief Given list of elements, return true if none of them is a resource element
          *
@@ -48,6 +48,10 @@ namespace snowcrash
 
             CaptureGroups captureGroups;
 
+            // Duplicate actions are looked up within a resource only
+            pd.actionsIndex.clear();
+            pd.relationsIndex.clear();
+
             // If Abbreviated resource section
             if (RegexCapture(node->text, ResourceHeaderRegex, captureGroups, 4)) {
 
@@ -161,7 +165,7 @@ namespace snowcrash
                 && (sectionType == ModelBodySectionType || sectionType == ModelSectionType)) {
 
                 mdp::ByteBuffer content
-                    = CodeBlockUtility::addDanglingAsset(node, pd, sectionType, out.report, out.node.model.body);
+                    = CodeBlockUtility::addDanglingAsset(node, pd, sectionType, out.report, out.node.model.body.buffer());
 
                 if (pd.exportSourceMap() && !content.empty()) {
                     out.sourceMap.model.body.sourceMap.append(node->sourceMap);
@@ -336,9 +340,13 @@ namespace snowcrash
         {
 
             IntermediateParseResult<Action> action(out.report);
+            size_t pendingReferences = pd.pendingReferences.size();
             MarkdownNodeIterator cur = ActionParser::parse(node, siblings, pd, action);
 
+            SectionProcessor<Action>::indexAction(action.node, pd);
+
             out.node.actions.push_back(action.node);
+            pd.locatePendingReferences(pendingReferences, &PendingReference::action, out.node.actions.size() - 1);
             layout = RedirectSectionLayout;
 
             if (pd.exportSourceMap()) {
@@ -357,11 +365,10 @@ namespace snowcrash
         {
 
             IntermediateParseResult<Action> action(out.report);
+            size_t pendingReferences = pd.pendingReferences.size();
             MarkdownNodeIterator cur = ActionParser::parse(node, siblings, pd, action);
 
-            ActionIterator duplicate = SectionProcessor<Action>::findAction(out.node.actions, action.node);
-
-            if (duplicate != out.node.actions.end()) {
+            if (SectionProcessor<Action>::isActionDuplicate(action.node, pd)) {
 
                 // WARN: duplicate method
                 std::stringstream ss;
@@ -373,10 +380,7 @@ namespace snowcrash
                 out.report.warnings.push_back(Warning(ss.str(), DuplicateWarning, sourceMap));
             }
 
-            ActionIterator relationDuplicate
-                = SectionProcessor<Action>::findRelation(out.node.actions, action.node.relation);
-
-            if (relationDuplicate != out.node.actions.end()) {
+            if (SectionProcessor<Action>::isRelationDuplicate(action.node.relation, pd)) {
 
                 // WARN: duplicate relation identifier
                 std::stringstream ss;
@@ -392,7 +396,10 @@ namespace snowcrash
                 checkParametersEligibility<Resource>(node, pd, action.node.parameters, out);
             }
 
+            SectionProcessor<Action>::indexAction(action.node, pd);
+
             out.node.actions.push_back(action.node);
+            pd.locatePendingReferences(pendingReferences, &PendingReference::action, out.node.actions.size() - 1);
 
             if (pd.exportSourceMap()) {
                 out.sourceMap.actions.collection.push_back(action.sourceMap);
@@ -507,26 +514,6 @@ namespace snowcrash
 
             return cur;
         }
-
-        /**
-         * \brief Given a list of elements, Check if a resource already exists with the given uri template
-         *
-         * \param elements Collection of elements
-         * \param uri The resource uri template to be checked
-         */
-        static bool isResourceDuplicate(const Elements& elements, const URITemplate& uri)
-        {
-
-            for (Elements::const_iterator it = elements.begin(); it != elements.end(); ++it) {
-
-                if (it->element == Element::ResourceElement && it->content.resource.uriTemplate == uri) {
-
-                    return true;
-                }
-            }
-
-            return false;
-        }
     };
 
     /** Resource Section Parser */
@@ -9,6 +9,7 @@
 #ifndef SNOWCRASH_SECTIONPARSERDATA_H
 #define SNOWCRASH_SECTIONPARSERDATA_H
 
+#include <unordered_set>
 #include "ModelTable.h"
 #include "BlueprintSourcemap.h"
 #include "Section.h"
@@ -30,6 +31,23 @@ namespace snowcrash
 
     typedef unsigned int BlueprintParserOptions;
 
+    /**
+     *  \brief Location of a payload with `Pending` model reference
+     *
+     *  Indexes into the collections of blueprint AST and its source map.
+     *  Each level is filled in as the enclosing section is added to its parent.
+     */
+    struct PendingReference {
+        size_t element;      /// < Resource group in blueprint elements
+        size_t resource;     /// < Resource in resource group elements
+        size_t action;       /// < Action in resource actions
+        size_t example;      /// < Transaction example in action examples
+        SectionType section; /// < `RequestSectionType` or `ResponseSectionType`
+        size_t payload;      /// < Request or response in transaction example
+    };
+
+    typedef std::vector<PendingReference> PendingReferences;
+
     /**
      *  \brief Section Parser Data
      *
@@ -65,6 +83,35 @@ namespace snowcrash
         /** Model Table Sourcemap */
         ModelSourceMapTable modelSourceMapTable;
 
+        /** URI templates of resources parsed so far - duplicates lookup */
+        std::unordered_set<URITemplate> resourcesIndex;
+
+        /** Names of resource groups parsed so far - duplicates lookup */
+        std::unordered_set<Name> resourceGroupsIndex;
+
+        /** Actions of the resource being parsed, see `actionIndexKey()` - duplicates lookup */
+        std::unordered_set<std::string> actionsIndex;
+
+        /** Relation identifiers of the resource being parsed - duplicates lookup */
+        std::unordered_set<std::string> relationsIndex;
+
+        /** Payloads with model references to be resolved once all models are known */
+        PendingReferences pendingReferences;
+
+        /**
+         *  \brief Set location level of pending references recorded since `first`
+         *  \param first   Size of `pendingReferences` before the section was parsed
+         *  \param level   Level of the location to be set
+         *  \param index   Index of the section in its parent collection
+         */
+        void locatePendingReferences(size_t first, size_t PendingReference::*level, size_t index)
+        {
+            for (PendingReferences::iterator it = pendingReferences.begin() + first; it != pendingReferences.end();
+                 ++it) {
+                (*it).*level = index;
+            }
+        }
+
         /** Source Data */
         const mdp::ByteBuffer& sourceData;
 
@@ -144,12 +144,25 @@ namespace snowcrash
      */
     inline std::string GetFirstLine(const std::string& s, std::string& r)
     {
-        std::vector<std::string> elem = SplitOnFirst(s, '\n');
-        if (elem.empty())
-            return std::string();
-        if (elem.size() > 1)
-            r = elem.back();
-        return elem.front();
+        std::string::size_type pos = s.find('\n');
+        if (pos == std::string::npos)
+            return s;
+
+        r.assign(s, pos + 1, std::string::npos);
+        return s.substr(0, pos);
+    }
+
+    /**
+     *  \brief  Retrieve the first line of a string
+     *
+     *  Unlike GetFirstLine(s, r) it does not copy the rest of the string.
+     *
+     *  \param  s   Subject string
+     *  \return First line from the subject string
+     */
+    inline std::string GetFirstLine(const std::string& s)
+    {
+        return s.substr(0, s.find('\n'));
     }
 
     /**
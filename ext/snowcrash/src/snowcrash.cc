@@ -8,40 +8,37 @@
 
 #include "snowcrash.h"
 #include "BlueprintParser.h"
+#include "Profile.h"
 
 const int snowcrash::SourceAnnotation::OK = 0;
 
 using namespace snowcrash;
 
 /**
- *  \brief  Check source for unsupported character \t & \r
+ *  \brief  Check scanned source for unsupported character \t & \r
  *  \return True if passed (not found), false otherwise
  */
-static bool CheckSource(const mdp::ByteBuffer& source, Report& report)
+static bool CheckSource(
+    const mdp::ByteBufferScan& scan, const mdp::ByteBufferCharacterIndex& index, Report& report)
 {
-
-    std::string::size_type pos = source.find("\t");
-
-    if (pos != std::string::npos) {
+    if (scan.tab != mdp::ByteBufferScan::npos) {
 
         mdp::BytesRangeSet rangeSet;
-        rangeSet.push_back(mdp::BytesRange(pos, 1));
+        rangeSet.push_back(mdp::BytesRange(scan.tab, 1));
         report.error = Error("the use of tab(s) '\\t' in source data isn't currently supported, please contact makers",
             BusinessError,
-            mdp::BytesRangeSetToCharactersRangeSet(rangeSet, source));
+            mdp::BytesRangeSetToCharactersRangeSet(rangeSet, index));
         return false;
     }
 
-    pos = source.find("\r");
-
-    if (pos != std::string::npos) {
+    if (scan.carriageReturn != mdp::ByteBufferScan::npos) {
 
         mdp::BytesRangeSet rangeSet;
-        rangeSet.push_back(mdp::BytesRange(pos, 1));
+        rangeSet.push_back(mdp::BytesRange(scan.carriageReturn, 1));
         report.error = Error(
             "the use of carriage return(s) '\\r' in source data isn't currently supported, please contact makers",
             BusinessError,
-            mdp::BytesRangeSetToCharactersRangeSet(rangeSet, source));
+            mdp::BytesRangeSetToCharactersRangeSet(rangeSet, index));
         return false;
     }
 
@@ -53,8 +50,12 @@ int snowcrash::parse(
 {
     try {
 
-        // Sanity Check
-        if (!CheckSource(source, out.report))
+        // Sanity Check, scanning the source only once
+        mdp::ByteBufferScan scan;
+        mdp::ByteBufferCharacterIndex characterIndex;
+        mdp::ScanByteBuffer(source, scan, characterIndex);
+
+        if (!CheckSource(scan, characterIndex, out.report))
             return out.report.error.code;
 
         // Do nothing if blueprint is empty
@@ -64,13 +65,17 @@ int snowcrash::parse(
         // Parse Markdown
         mdp::MarkdownParser markdownParser;
         mdp::MarkdownNode markdownAST;
-        markdownParser.parse(source, markdownAST);
+        {
+            ProfileScope scope(MarkdownParseStage);
+            markdownParser.parse(source, markdownAST);
+        }
 
         // Build SectionParserData
         SectionParserData pd(options, source, out.node);
-        mdp::BuildCharacterIndex(pd.sourceCharacterIndex, source);
+        pd.sourceCharacterIndex.swap(characterIndex);
 
         // Parse Blueprint
+        ProfileScope scope(BlueprintParseStage);
         BlueprintParser::parse(markdownAST.children().begin(), markdownAST.children(), pd, out);
     } catch (const Error& e) {
         out.report.error = e;
@@ -0,0 +1,303 @@
+//
+//  generate-blueprint.cc
+//  snowcrash
+//
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+
+/**
+ *  \brief Parameters of generated blueprint
+ */
+struct GeneratorOptions {
+    unsigned int groups;       /// < Number of resource groups
+    unsigned int resources;    /// < Resources per group
+    unsigned int actions;      /// < Actions per resource
+    unsigned int transactions; /// < Request/Response pairs per action
+    unsigned int types;        /// < Named data structures
+    unsigned int depth;        /// < Inheritance depth of named data structures
+    unsigned int mixins;       /// < Mixins included by each named data structure
+    unsigned int oneOfs;       /// < `One Of` sections in each named data structure
+    unsigned int members;      /// < Own members of each named data structure
+    unsigned int bodySize;     /// < Size of explicit request body in bytes
+    unsigned int annotations;  /// < Percentage of actions producing a warning
+    unsigned int seed;         /// < Seed of the pseudo random sequence
+    std::string output;        /// < Output file, stdout if empty
+
+    GeneratorOptions()
+        : groups(2),
+          resources(5),
+          actions(2),
+          transactions(1),
+          types(10),
+          depth(2),
+          mixins(1),
+          oneOfs(0),
+          members(3),
+          bodySize(64),
+          annotations(0),
+          seed(1)
+    {
+    }
+};
+
+/**
+ *  \brief Small deterministic pseudo random generator
+ *
+ *  Linear congruential generator, gives the same sequence
+ *  on every platform so generated fixtures are reproducible.
+ */
+class Random
+{
+    unsigned long long state;
+
+public:
+    explicit Random(unsigned int seed) : state(seed) {}
+
+    unsigned int next(unsigned int bound)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return bound ? static_cast<unsigned int>((state >> 33) % bound) : 0;
+    }
+};
+
+static std::string TypeName(unsigned int index)
+{
+    std::stringstream ss;
+    ss << "Type" << index;
+    return ss.str();
+}
+
+/**
+ *  \brief Index of the first type in the inheritance chain of type `index`
+ */
+static unsigned int ChainRoot(unsigned int index, const GeneratorOptions& options)
+{
+    return index - index % (options.depth + 1);
+}
+
+static void GenerateDataStructures(std::ostream& os, const GeneratorOptions& options, Random& random)
+{
+    if (!options.types)
+        return;
+
+    os << "# Data Structures\n\n";
+
+    for (unsigned int i = 0; i < options.types; ++i) {
+        unsigned int root = ChainRoot(i, options);
+
+        // Inherit from previous type in the chain
+        os << "## " << TypeName(i) << " (" << (i == root ? std::string("object") : TypeName(i - 1)) << ")\n\n";
+
+        for (unsigned int m = 0; m < options.members; ++m) {
+            switch ((i + m) % 3) {
+                case 0:
+                    os << "+ number" << i << "_" << m << ": " << random.next(1000) << " (number, required)\n";
+                    break;
+                case 1:
+                    os << "+ string" << i << "_" << m << ": value " << random.next(1000) << "\n";
+                    break;
+                default:
+                    os << "+ array" << i << "_" << m << " (array[string])\n";
+                    os << "    + item " << random.next(1000) << "\n";
+                    break;
+            }
+        }
+
+        // Mixins are taken from preceding chains only to avoid circular references
+        for (unsigned int x = 0; x < options.mixins && root > 0; ++x) {
+            os << "+ Include " << TypeName(random.next(root)) << "\n";
+        }
+
+        for (unsigned int o = 0; o < options.oneOfs; ++o) {
+            os << "+ One Of\n";
+            os << "    + option" << i << "_" << o << "_a: a (string)\n";
+            os << "    + option" << i << "_" << o << "_b: " << random.next(1000) << " (number)\n";
+        }
+
+        os << "\n";
+    }
+}
+
+static void GenerateBody(std::ostream& os, const GeneratorOptions& options, const std::string& indentation)
+{
+    os << indentation << "{\n";
+    os << indentation << "    \"data\": \"";
+
+    for (unsigned int i = 0; i < options.bodySize; ++i) {
+        os << static_cast<char>('a' + i % 26);
+    }
+
+    os << "\"\n";
+    os << indentation << "}\n\n";
+}
+
+static void GenerateAction(std::ostream& os,
+    const GeneratorOptions& options,
+    Random& random,
+    unsigned int group,
+    unsigned int resource,
+    unsigned int action)
+{
+    static const char* const Methods[] = { "GET", "POST", "PUT", "PATCH", "DELETE" };
+    static const unsigned int MethodCount = sizeof(Methods) / sizeof(Methods[0]);
+
+    // Methods has to be unique within resource
+    if (action >= MethodCount)
+        return;
+
+    os << "### Action " << group << "." << resource << "." << action << " [" << Methods[action] << "]\n\n";
+    os << "Action description " << random.next(1000) << ".\n\n";
+
+    for (unsigned int t = 0; t < options.transactions; ++t) {
+
+        os << "+ Request " << t << " (application/json)\n\n";
+
+        if (options.types) {
+            os << "    + Attributes (" << TypeName(random.next(options.types)) << ")\n\n";
+        }
+
+        if (options.bodySize) {
+            os << "    + Body\n\n";
+            GenerateBody(os, options, "            ");
+        }
+
+        os << "+ Response 200 (application/json)\n\n";
+
+        if (options.types) {
+            os << "    + Attributes (" << TypeName(random.next(options.types)) << ")\n\n";
+        } else {
+            GenerateBody(os, options, "        ");
+        }
+    }
+
+    // Body not indented as a code block produces a warning
+    if (random.next(100) < options.annotations) {
+        os << "+ Response 404 (text/plain)\n\n";
+        os << "    Not Found\n\n";
+    }
+}
+
+static void GenerateResources(std::ostream& os, const GeneratorOptions& options, Random& random)
+{
+    for (unsigned int g = 0; g < options.groups; ++g) {
+        os << "# Group Collection " << g << "\n\n";
+        os << "Group description " << g << ".\n\n";
+
+        for (unsigned int r = 0; r < options.resources; ++r) {
+            os << "## Resource " << g << "." << r << " [/group" << g << "/resource" << r << "/{id}]\n\n";
+            os << "Resource description " << random.next(1000) << ".\n\n";
+
+            os << "+ Parameters\n";
+            os << "    + id: `" << random.next(1000) << "` (number) - Identifier of the resource\n\n";
+
+            for (unsigned int a = 0; a < options.actions; ++a) {
+                GenerateAction(os, options, random, g, r, a);
+            }
+        }
+    }
+}
+
+static void Generate(std::ostream& os, const GeneratorOptions& options)
+{
+    Random random(options.seed);
+
+    os << "FORMAT: 1A\n\n";
+    os << "# Synthetic API\n\n";
+    os << "Generated with " << options.groups << " groups, " << options.resources << " resources, "
+       << options.actions << " actions, " << options.types << " types.\n\n";
+
+    GenerateResources(os, options, random);
+    GenerateDataStructures(os, options, random);
+}
+
+void help()
+{
+    std::cout << "usage: generate-blueprint [options] ..." << std::endl << std::endl;
+    std::cout << "Synthetic API Blueprint Generator" << std::endl << std::endl;
+    std::cout << "options:" << std::endl << std::endl;
+    std::cout << "  --groups <n>        number of resource groups" << std::endl;
+    std::cout << "  --resources <n>     number of resources in each group" << std::endl;
+    std::cout << "  --actions <n>       number of actions in each resource (up to 5)" << std::endl;
+    std::cout << "  --transactions <n>  number of request/response pairs in each action" << std::endl;
+    std::cout << "  --types <n>         number of named data structures" << std::endl;
+    std::cout << "  --depth <n>         inheritance depth of named data structures" << std::endl;
+    std::cout << "  --mixins <n>        number of mixins included by each data structure" << std::endl;
+    std::cout << "  --one-ofs <n>       number of `One Of` sections in each data structure" << std::endl;
+    std::cout << "  --members <n>       number of own members of each data structure" << std::endl;
+    std::cout << "  --body-size <n>     size of explicit request bodies in bytes" << std::endl;
+    std::cout << "  --annotations <n>   percentage of actions producing a warning" << std::endl;
+    std::cout << "  --seed <n>          seed of the pseudo random sequence" << std::endl;
+    std::cout << "  -o, --output <file> save generated blueprint into file" << std::endl;
+    std::cout << "  -h, --help          display this help message" << std::endl;
+    exit(0);
+}
+
+static unsigned int NumericArgument(int argc, const char* argv[], int& i)
+{
+    if (i + 1 >= argc) {
+        std::cerr << "missing value of '" << argv[i] << "'\n";
+        exit(EXIT_FAILURE);
+    }
+
+    return static_cast<unsigned int>(strtoul(argv[++i], NULL, 10));
+}
+
+int main(int argc, const char* argv[])
+{
+    GeneratorOptions options;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "-h" || arg == "--help") {
+            help();
+        } else if (arg == "--groups") {
+            options.groups = NumericArgument(argc, argv, i);
+        } else if (arg == "--resources") {
+            options.resources = NumericArgument(argc, argv, i);
+        } else if (arg == "--actions") {
+            options.actions = NumericArgument(argc, argv, i);
+        } else if (arg == "--transactions") {
+            options.transactions = NumericArgument(argc, argv, i);
+        } else if (arg == "--types") {
+            options.types = NumericArgument(argc, argv, i);
+        } else if (arg == "--depth") {
+            options.depth = NumericArgument(argc, argv, i);
+        } else if (arg == "--mixins") {
+            options.mixins = NumericArgument(argc, argv, i);
+        } else if (arg == "--one-ofs") {
+            options.oneOfs = NumericArgument(argc, argv, i);
+        } else if (arg == "--members") {
+            options.members = NumericArgument(argc, argv, i);
+        } else if (arg == "--body-size") {
+            options.bodySize = NumericArgument(argc, argv, i);
+        } else if (arg == "--annotations") {
+            options.annotations = NumericArgument(argc, argv, i);
+        } else if (arg == "--seed") {
+            options.seed = NumericArgument(argc, argv, i);
+        } else if ((arg == "-o" || arg == "--output") && i + 1 < argc) {
+            options.output = argv[++i];
+        } else {
+            std::cerr << "unknown option '" << arg << "'\n";
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (options.output.empty()) {
+        Generate(std::cout, options);
+        return EXIT_SUCCESS;
+    }
+
+    std::ofstream outputFileStream(options.output.c_str());
+    if (!outputFileStream.is_open()) {
+        std::cerr << "fatal: unable to open output file '" << options.output << "'\n";
+        exit(EXIT_FAILURE);
+    }
+
+    Generate(outputFileStream, options);
+
+    return EXIT_SUCCESS;
+}
@@ -28,3 +28,21 @@ TEST_CASE("blueprint/init", "Blueprint initialization")
     REQUIRE(blueprint.metadata.size() == 0);
     REQUIRE(blueprint.content.elements().size() == 0);
 }
+
+TEST_CASE("blueprint/asset-sharing", "Copies of an asset share its text until modified")
+{
+    Payload model;
+    model.body = "{ \"id\": 1 }\n";
+
+    Payload payload = model;
+    REQUIRE(payload.body == "{ \"id\": 1 }\n");
+    REQUIRE(payload.body.c_str() == model.body.c_str());
+
+    payload.body.buffer() += "\n";
+    REQUIRE(payload.body == "{ \"id\": 1 }\n\n");
+    REQUIRE(model.body == "{ \"id\": 1 }\n");
+
+    Asset empty;
+    REQUIRE(empty.empty());
+    REQUIRE(empty == "");
+}
@@ -1499,3 +1499,56 @@ TEST_CASE("Parse blueprint with random header node after resource", "[blueprint]
     REQUIRE(blueprint.report.error.code != Error::OK);
     REQUIRE(blueprint.report.warnings.size() == 1);
 }
+
+TEST_CASE("Warn about each duplicate metadata key once", "[blueprint]")
+{
+    mdp::ByteBuffer source
+        = "FORMAT: 1A\n"
+          "meta: one\n"
+          "meta: two\n"
+          "FORMAT: 1B\n"
+          "meta: three\n"
+          "\n"
+          "# API\n";
+
+    ParseResult<Blueprint> blueprint;
+    SectionParserHelper<Blueprint, BlueprintParser>::parse(source, BlueprintSectionType, blueprint);
+
+    REQUIRE(blueprint.report.error.code == Error::OK);
+    REQUIRE(blueprint.report.warnings.size() == 2);
+    REQUIRE(blueprint.report.warnings[0].code == DuplicateWarning);
+    REQUIRE(blueprint.report.warnings[0].message == "duplicate definition of 'FORMAT'");
+    REQUIRE(blueprint.report.warnings[1].code == DuplicateWarning);
+    REQUIRE(blueprint.report.warnings[1].message == "duplicate definition of 'meta'");
+
+    REQUIRE(blueprint.node.metadata.size() == 5);
+}
+
+TEST_CASE("Warn about duplicate resource groups and resources across groups", "[blueprint]")
+{
+    mdp::ByteBuffer source
+        = "# API\n"
+          "# Group A\n"
+          "## /a\n"
+          "### GET\n"
+          "+ Response 200\n"
+          "\n"
+          "# Group B\n"
+          "## /a\n"
+          "### GET\n"
+          "+ Response 200\n"
+          "\n"
+          "# Group A\n";
+
+    ParseResult<Blueprint> blueprint;
+    SectionParserHelper<Blueprint, BlueprintParser>::parse(source, BlueprintSectionType, blueprint);
+
+    REQUIRE(blueprint.report.error.code == Error::OK);
+    REQUIRE(blueprint.report.warnings.size() == 2);
+    REQUIRE(blueprint.report.warnings[0].code == DuplicateWarning);
+    REQUIRE(blueprint.report.warnings[0].message == "the resource '/a' is already defined");
+    REQUIRE(blueprint.report.warnings[1].code == DuplicateWarning);
+    REQUIRE(blueprint.report.warnings[1].message == "group 'A' is already defined");
+
+    REQUIRE(blueprint.node.content.elements().size() == 3);
+}
@@ -0,0 +1,191 @@
+//
+//  test-Profile.cc
+//  snowcrash
+//
+
+#include "snowcrashtest.h"
+#include "snowcrash.h"
+#include "Profile.h"
+
+#include <sstream>
+
+using namespace snowcrash;
+
+namespace
+{
+    // Calls of replaceable allocation functions are never elided,
+    // unlike new-expressions
+    void AllocateAndRelease(size_t size)
+    {
+        void* p = ::operator new(size);
+        ::operator delete(p);
+    }
+}
+
+TEST_CASE("Profile counts allocations of active stage", "[profile]")
+{
+    Profile profile;
+
+    {
+        ProfileSession session(&profile);
+        ProfileScope scope(MarkdownParseStage);
+
+        AllocateAndRelease(64);
+    }
+
+    const StageStatistics& statistics = profile.stage(MarkdownParseStage);
+
+    REQUIRE(statistics.calls == 1);
+
+    if (Profile::tracksAllocations()) {
+        REQUIRE(statistics.allocations >= 1);
+        REQUIRE(statistics.deallocations >= 1);
+        REQUIRE(statistics.bytes >= 64);
+    } else {
+        REQUIRE(statistics.allocations == 0);
+        REQUIRE(statistics.deallocations == 0);
+        REQUIRE(statistics.bytes == 0);
+    }
+}
+
+TEST_CASE("Profile counts allocations to innermost stage only", "[profile]")
+{
+    Profile profile;
+
+    {
+        ProfileSession session(&profile);
+        ProfileScope outer(BlueprintParseStage);
+
+        {
+            ProfileScope inner(MarkdownParseStage);
+            AllocateAndRelease(32);
+        }
+    }
+
+    REQUIRE(profile.stage(BlueprintParseStage).allocations == 0);
+    REQUIRE(profile.stage(BlueprintParseStage).bytes == 0);
+
+    if (Profile::tracksAllocations()) {
+        REQUIRE(profile.stage(MarkdownParseStage).allocations >= 1);
+        REQUIRE(profile.stage(MarkdownParseStage).bytes >= 32);
+    }
+}
+
+TEST_CASE("Profile counts nothing outside of stage and session", "[profile]")
+{
+    Profile profile;
+
+    AllocateAndRelease(64);
+
+    {
+        ProfileSession session(&profile);
+        AllocateAndRelease(64);
+    }
+
+    {
+        ProfileSession session(&profile);
+        ProfileScope scope(MarkdownParseStage);
+    }
+
+    AllocateAndRelease(64);
+
+    const StageStatistics& statistics = profile.stage(MarkdownParseStage);
+
+    REQUIRE(statistics.calls == 1);
+    REQUIRE(statistics.allocations == 0);
+    REQUIRE(statistics.deallocations == 0);
+    REQUIRE(statistics.bytes == 0);
+}
+
+TEST_CASE("Disabled profile session counts nothing", "[profile]")
+{
+    Profile profile;
+
+    {
+        ProfileSession session(&profile);
+
+        {
+            ProfileSession disabled(NULL);
+            REQUIRE(Profile::current() == NULL);
+
+            ProfileScope scope(MarkdownParseStage);
+            AllocateAndRelease(64);
+        }
+
+        REQUIRE(Profile::current() == &profile);
+    }
+
+    REQUIRE(Profile::current() == NULL);
+
+    const StageStatistics& statistics = profile.stage(MarkdownParseStage);
+
+    REQUIRE(statistics.calls == 0);
+    REQUIRE(statistics.allocations == 0);
+    REQUIRE(statistics.bytes == 0);
+}
+
+TEST_CASE("Profiled parse fills allocation counters", "[profile]")
+{
+    Profile profile;
+    ParseResult<Blueprint> blueprint;
+
+    {
+        ProfileSession session(&profile);
+        parse("# API\n## GET /message\n+ Response 200 (text/plain)\n\n        Hello World!\n", 0, blueprint);
+    }
+
+    REQUIRE(blueprint.report.error.code == Error::OK);
+    REQUIRE(profile.stage(MarkdownParseStage).calls == 1);
+    REQUIRE(profile.stage(BlueprintParseStage).calls == 1);
+
+    if (Profile::tracksAllocations()) {
+        REQUIRE(profile.stage(MarkdownParseStage).allocations > 0);
+        REQUIRE(profile.stage(MarkdownParseStage).bytes > 0);
+        REQUIRE(profile.stage(BlueprintParseStage).allocations > 0);
+        REQUIRE(profile.stage(BlueprintParseStage).bytes > 0);
+    } else {
+        REQUIRE(profile.stage(MarkdownParseStage).allocations == 0);
+        REQUIRE(profile.stage(BlueprintParseStage).allocations == 0);
+    }
+}
+
+TEST_CASE("Profile of worker thread is merged into profile", "[profile]")
+{
+    Profile profile;
+    Profile worker;
+
+    profile.trace(true);
+    worker.trace(true);
+
+    {
+        ProfileSession session(&profile);
+        ProfileScope scope(RefractStage);
+    }
+
+    {
+        ProfileSession session(&worker);
+        ProfileScope scope(RenderBodyStage);
+        TraceScope trace("payload", "200", mdp::BytesRangeSet());
+    }
+
+    profile.merge(worker, 2);
+
+    REQUIRE(profile.stage(RefractStage).calls == 1);
+    REQUIRE(profile.stage(RenderBodyStage).calls == 1);
+    REQUIRE(profile.stage(RenderBodyStage).total == worker.stage(RenderBodyStage).total);
+
+    const std::vector<TraceEvent>& events = profile.events();
+
+    REQUIRE(events.size() == 3);
+    REQUIRE(events[0].thread == 0);
+    REQUIRE(events[1].name == "render body");
+    REQUIRE(events[1].thread == 2);
+    REQUIRE(events[2].category == std::string("payload"));
+    REQUIRE(events[2].thread == 2);
+    REQUIRE(events[1].start >= events[0].start);
+
+    std::ostringstream trace;
+    profile.writeTrace(trace);
+
+    REQUIRE(trace.str().find("\"cat\":\"payload\",\"ph\":\"X\",\"pid\":1,\"tid\":3,") != std::string::npos);
+}
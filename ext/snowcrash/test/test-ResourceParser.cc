@@ -616,6 +616,81 @@ TEST_CASE("Parse named resource with lazy referencing with both response and req
     REQUIRE(resource.actions[0].examples[0].responses[0].reference.meta.state == Reference::StateResolved);
 }
 
+TEST_CASE("Parse lazy referencing across resource groups", "[resource][model]")
+{
+    mdp::ByteBuffer source
+        = "# API\n"
+          "\n"
+          "# Group A\n"
+          "\n"
+          "## Note [/notes/{id}]\n"
+          "+ Model (text/plain)\n"
+          "\n"
+          "        note\n"
+          "\n"
+          "### Retrieve [GET]\n"
+          "+ Response 200\n"
+          "\n"
+          "    [Note][]\n"
+          "\n"
+          "# Group B\n"
+          "\n"
+          "## Items [/items]\n"
+          "### Create [POST]\n"
+          "+ Request\n"
+          "\n"
+          "    [Item][]\n"
+          "\n"
+          "+ Response 201\n"
+          "\n"
+          "    [Item][]\n"
+          "\n"
+          "+ Request\n"
+          "\n"
+          "    [Note][]\n"
+          "\n"
+          "+ Response 200\n"
+          "\n"
+          "    [Item][]\n"
+          "\n"
+          "## Item [/items/{id}]\n"
+          "+ Model (text/plain)\n"
+          "\n"
+          "        item\n";
+
+    ParseResult<Blueprint> blueprint;
+    parse(source, ExportSourcemapOption, blueprint);
+
+    REQUIRE(blueprint.report.error.code == Error::OK);
+    REQUIRE(blueprint.report.warnings.empty());
+
+    REQUIRE(blueprint.node.content.elements().size() == 2);
+    REQUIRE(blueprint.node.content.elements().at(1).content.elements().size() == 2);
+
+    Resource resource = blueprint.node.content.elements().at(1).content.elements().at(0).content.resource;
+    REQUIRE(resource.actions.size() == 1);
+    REQUIRE(resource.actions[0].examples.size() == 2);
+
+    REQUIRE(resource.actions[0].examples[0].requests[0].body == "item\n");
+    REQUIRE(resource.actions[0].examples[0].requests[0].reference.meta.state == Reference::StateResolved);
+    REQUIRE(resource.actions[0].examples[0].responses[0].body == "item\n");
+    REQUIRE(resource.actions[0].examples[0].responses[0].reference.meta.state == Reference::StateResolved);
+    REQUIRE(resource.actions[0].examples[1].requests[0].body == "note\n");
+    REQUIRE(resource.actions[0].examples[1].requests[0].reference.meta.state == Reference::StateResolved);
+    REQUIRE(resource.actions[0].examples[1].responses[0].body == "item\n");
+    REQUIRE(resource.actions[0].examples[1].responses[0].reference.meta.state == Reference::StateResolved);
+
+    SourceMap<TransactionExamples> examplesSourceMap = blueprint.sourceMap.content.elements()
+                                                           .collection[1]
+                                                           .content.elements()
+                                                           .collection[0]
+                                                           .content.resource.actions.collection[0]
+                                                           .examples;
+
+    REQUIRE(examplesSourceMap.collection.size() == 2);
+    REQUIRE(examplesSourceMap.collection[1].responses.collection[0].body.sourceMap.size() == 1);
+}
+
 TEST_CASE("Expect to have a warning when 100 responses reference has a body", "[resource][model]")
 {
     mdp::ByteBuffer source
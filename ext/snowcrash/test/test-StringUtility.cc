@@ -112,3 +112,21 @@ TEST_CASE("Get trim info", "[utility]")
     REQUIRE(std::get<0>(range) == 3);
     REQUIRE(std::get<1>(range) == 3);
 }
+
+TEST_CASE("Get first line", "[utility]")
+{
+    std::string remaining;
+
+    REQUIRE(GetFirstLine("abc", remaining) == "abc");
+    REQUIRE(remaining.empty());
+
+    REQUIRE(GetFirstLine("abc\ndef\nghi", remaining) == "abc");
+    REQUIRE(remaining == "def\nghi");
+
+    REQUIRE(GetFirstLine("abc\n", remaining) == "abc");
+    REQUIRE(remaining.empty());
+
+    REQUIRE(GetFirstLine("abc\ndef") == "abc");
+    REQUIRE(GetFirstLine("abc") == "abc");
+    REQUIRE(GetFirstLine("") == "");
+}
@@ -7,10 +7,31 @@
 //
 
 #include "ConversionContext.h"
+#include "Serialize.h"
 
 namespace drafter
 {
 
+    ConversionContext::ConversionContext(const WrapperOptions& options)
+        : registry(std::make_shared<refract::Registry>()),
+          schemaCache(std::make_shared<refract::JSONSchemaCache>(options.schemaReferences)),
+          options(options)
+    {
+    }
+
+    ConversionContext::ConversionContext(
+        const WrapperOptions& options, const std::shared_ptr<refract::Registry>& registry)
+        : registry(registry),
+          schemaCache(std::make_shared<refract::JSONSchemaCache>(options.schemaReferences)),
+          options(options)
+    {
+    }
+
+    std::unique_ptr<ConversionContext> ConversionContext::CreateWorker() const
+    {
+        return std::unique_ptr<ConversionContext>(new ConversionContext(options, registry));
+    }
+
     void ConversionContext::warn(const snowcrash::Warning& warning)
     {
         for (auto& item : warnings) {
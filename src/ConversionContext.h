@@ -9,31 +9,101 @@
 #define DRAFTER_CONVERSIONCONTEXT_H
 
 #include "refract/Registry.h"
+#include "refract/Symbol.h"
+#include "refract/JSONSchemaCache.h"
+#include "Render.h"
+#include "ResultAssets.h"
+
+#include <functional>
+#include <memory>
 #include "snowcrash.h"
 
 namespace drafter
 {
 
     struct WrapperOptions;
+    class ConversionContext;
+
+    /**
+     * Rendering of payload assets run on worker thread,
+     * see `WrapperOptions::renderThreads`
+     */
+    struct RenderJob {
+        /** Payload element rendered assets are appended to */
+        refract::ArrayElement* payload;
+
+        /** Count of context warnings issued before the job */
+        size_t warnings;
+
+        /** Renders assets in context of worker thread */
+        std::function<refract::RefractElements(ConversionContext&)> render;
+    };
+
+    typedef std::vector<RenderJob> RenderJobs;
 
     class ConversionContext
     {
-        refract::Registry registry;
+        std::shared_ptr<refract::Registry> registry;
+        std::shared_ptr<refract::JSONSchemaCache> schemaCache;
+        RenderFormatCache renderFormats;
+        refract::SymbolTable symbols;
+
+        ConversionContext(const WrapperOptions& options, const std::shared_ptr<refract::Registry>& registry);
 
     public:
         const WrapperOptions& options;
         std::vector<snowcrash::Warning> warnings;
 
+        /** Assets rendered on demand, see `WrapperOptions::lazyRender` */
+        PendingAssets pendingAssets;
+
+        /** Payloads waiting to be rendered, see `RunRenderJobs()` */
+        RenderJobs renderJobs;
+
+        /** Annotations of parse result made by `WrapRefract()` */
+        Annotations annotations;
+
         inline refract::Registry& GetNamedTypesRegistry()
         {
-            return registry;
+            return *registry;
         }
         inline const refract::Registry& GetNamedTypesRegistry() const
         {
-            return registry;
+            return *registry;
         }
 
-        ConversionContext(const WrapperOptions& options) : options(options) {}
+        inline refract::JSONSchemaCache& GetJSONSchemaCache()
+        {
+            return *schemaCache;
+        }
+
+        /** Cache kept for rendering deferred beyond lifetime of the context */
+        inline std::shared_ptr<refract::JSONSchemaCache> ShareJSONSchemaCache()
+        {
+            return schemaCache;
+        }
+
+        inline RenderFormatCache& GetRenderFormatCache()
+        {
+            return renderFormats;
+        }
+
+        /** Element names interned while converting, see `refract::SymbolScope` */
+        inline refract::SymbolTable& GetSymbolTable()
+        {
+            return symbols;
+        }
+
+        ConversionContext(const WrapperOptions& options);
+
+        /**
+         * Context of worker thread
+         *
+         * Shares options and named types registry with this context, the
+         * registry has to stay unchanged while the worker is used.
+         * Caches, symbol table and warnings are its own.
+         */
+        std::unique_ptr<ConversionContext> CreateWorker() const;
 
         void warn(const snowcrash::Warning& warning);
     };
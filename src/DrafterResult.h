@@ -0,0 +1,40 @@
+//
+//  DrafterResult.h
+//  drafter
+//
+#ifndef DRAFTER_DRAFTERRESULT_H
+#define DRAFTER_DRAFTERRESULT_H
+
+#include <memory>
+#include <mutex>
+
+#include "drafter.h"
+#include "Profile.h"
+#include "ResultAssets.h"
+
+#include "refract/Element.h"
+
+/**
+ *  \brief Result handle of the C API
+ *
+ *  Owns element tree of the result together with everything else the C API
+ *  returns about it, all of it is released by `drafter_free_result()`.
+ */
+struct drafter_result {
+    /** Element tree of the result */
+    std::unique_ptr<refract::IElement> element;
+
+    /** Profile of the parse, see `drafter_parse_options_ex::profile` */
+    std::unique_ptr<snowcrash::Profile> profile;
+
+    /** Assets rendered by first `drafter_serialize()`, see `WrapperOptions::lazyRender` */
+    drafter::PendingAssets pendingAssets;
+
+    /** Annotations of the result, see `drafter_annotations()` */
+    drafter::Annotations annotations;
+
+    /** Serializes C API calls completing the result, the first of them renders pending assets */
+    std::mutex mutex;
+};
+
+#endif // #ifndef DRAFTER_DRAFTERRESULT_H
@@ -384,6 +384,9 @@ namespace drafter
             }
         }
 
+        // Second level registration - types are converted in inheritance order, replacing
+        // their placeholders. The registry changes after every type, so roots are walked
+        // here. Roots resolved up front would point to placeholders deleted meanwhile.
         for (DataStructures::const_iterator i = found.begin(); i != found.end(); ++i) {
 
             if (!i->node->name.symbol.literal.empty()) {
@@ -398,9 +401,7 @@ namespace drafter
 #endif /* DEBUG_DEPENDENCIES */
 
                 // remove preregistrated element
-                refract::IElement* pre = context.GetNamedTypesRegistry().find(name);
                 context.GetNamedTypesRegistry().remove(name);
-                delete pre;
 
                 try {
                     context.GetNamedTypesRegistry().add(element);
@@ -412,6 +413,8 @@ namespace drafter
             }
         }
 
+        context.GetNamedTypesRegistry().resolve();
+
 #ifdef DEBUG_DEPENDENCIES
         std::cout << "==DEPENDENCIES INFO END==" << std::endl;
 #endif /* DEBUG_DEPENDENCIES */
@@ -56,6 +56,7 @@ namespace drafter
         {
         }
         NodeInfo() : node(Type::NullNode()), sourceMap(Type::NullSourceMap()), empty(true) {}
+        NodeInfo(const NodeInfo<T>& other) : node(other.node), sourceMap(other.sourceMap), empty(other.empty) {}
 
         NodeInfo<T>& operator=(const NodeInfo<T>& other)
         {
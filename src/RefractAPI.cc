@@ -12,8 +12,12 @@
 #include "Render.h"
 
 #include "RefractSourceMap.h"
+#include "Profile.h"
+#include "TaskPool.h"
 
+#include <exception>
 #include <iterator>
+#include <memory>
 #include <set>
 
 #include "NamedTypesRegistry.h"
@@ -231,6 +235,17 @@ namespace drafter
         return element;
     }
 
+    void SetAssetInfo(refract::IElement* element, const std::string& contentType, const std::string& metaClass)
+    {
+        element->element(SerializeKey::Asset);
+        element->meta[SerializeKey::Classes] = CreateArrayElement(metaClass);
+
+        if (!contentType.empty()) {
+            // FIXME: "contentType" has no sourceMap?
+            element->attributes[SerializeKey::ContentType] = refract::IElement::Create(contentType);
+        }
+    }
+
     refract::IElement* AssetToRefract(
         const NodeInfo<snowcrash::Asset>& asset, const std::string& contentType, const std::string& metaClass)
     {
@@ -238,19 +253,109 @@ namespace drafter
             return NULL;
         }
 
-        refract::IElement* element = PrimitiveToRefract(asset);
+        refract::IElement* element = refract::IElement::Create(asset.node->str());
+        AttachSourceMap(element, asset);
 
-        element->element(SerializeKey::Asset);
-        element->meta[SerializeKey::Classes] = CreateArrayElement(metaClass);
+        SetAssetInfo(element, contentType, metaClass);
 
-        if (!contentType.empty()) {
-            // FIXME: "contentType" has no sourceMap?
-            element->attributes[SerializeKey::ContentType] = refract::IElement::Create(contentType);
-        }
+        return element;
+    }
+
+    refract::IElement* PendingAssetToRefract(std::function<std::string()>&& render,
+        const std::string& contentType,
+        const std::string& metaClass,
+        ConversionContext& context)
+    {
+        refract::StringElement* element = new refract::StringElement;
+
+        SetAssetInfo(element, contentType, metaClass);
+
+        PendingAsset pending;
+        pending.asset = element;
+        pending.render = std::move(render);
+        pending.payload = NULL; // filled in by PayloadToRefract()
+        context.pendingAssets.push_back(std::move(pending));
 
         return element;
     }
 
+    RefractElements PayloadAssetsToRefract(const NodeInfo<snowcrash::Payload>& payload,
+        const NodeInfo<snowcrash::Action>& action,
+        ConversionContext& context)
+    {
+        RefractElements assets;
+
+        snowcrash::TraceScope trace("payload", payload.node->name, payload.sourceMap->sourceMap);
+
+        // FIXME: This whole rendering should be done after converting to refract. Currently, both
+        // the renders will do MSONToRefract individually on the same thing. So, basically, the attributes
+        // in a payload gets converted to refract 3 times which is something we should fix.
+        try {
+            // Get content type, it is classified once for both renderers
+            std::string contentType = getContentTypeFromHeaders(payload.node->headers);
+            RenderFormat renderFormat = context.GetRenderFormatCache().find(contentType);
+
+            std::string schemaContentType
+                = renderFormat != UndefinedRenderFormat ? JSONSchemaContentType : contentType;
+
+            if (context.options.lazyRender) {
+                DeferredPayloadRender render = deferPayloadRender(payload, action, renderFormat, context);
+
+                if (render.body) {
+                    assets.push_back(PendingAssetToRefract(
+                        std::move(render.body), contentType, SerializeKey::MessageBody, context));
+                } else {
+                    assets.push_back(
+                        AssetToRefract(MAKE_NODE_INFO(payload, body), contentType, SerializeKey::MessageBody));
+                }
+
+                if (render.schema) {
+                    assets.push_back(PendingAssetToRefract(
+                        std::move(render.schema), schemaContentType, SerializeKey::MessageBodySchema, context));
+                } else if (!payload.node->schema.empty()) {
+                    assets.push_back(AssetToRefract(
+                        MAKE_NODE_INFO(payload, schema), schemaContentType, SerializeKey::MessageBodySchema));
+                }
+            } else {
+                // Render using boutique
+                NodeInfoByValue<snowcrash::Asset> payloadBody
+                    = renderPayloadBody(payload, action, renderFormat, context);
+                NodeInfoByValue<snowcrash::Asset> payloadSchema
+                    = renderPayloadSchema(payload, action, renderFormat, context);
+
+                // Push Body Asset
+                assets.push_back(
+                    AssetToRefract(NodeInfo<snowcrash::Asset>(payloadBody), contentType, SerializeKey::MessageBody));
+
+                // Render only if Body is JSON or Schema is defined
+                if (!payloadSchema.first.empty()) {
+                    assets.push_back(AssetToRefract(NodeInfo<snowcrash::Asset>(payloadSchema),
+                        schemaContentType,
+                        SerializeKey::MessageBodySchema));
+                }
+            }
+        }
+
+        // what to do?
+        // we are not able to generate JSON and/or JSON Schema
+        // this is not fatal, rethrow will finish conversion
+
+        // ideal solution is add warning into collection
+        // but there is no way how to do it
+        // in current time we solve it by rethrow
+        catch (snowcrash::Error& e) {
+            context.warn(snowcrash::Warning("unable to render JSON/JSONSchema. " + e.message,
+                snowcrash::ApplicationError,
+                payload.sourceMap->sourceMap));
+        } catch (refract::LogicError& e) {
+            context.warn(snowcrash::Warning(std::string("unable to render JSON/JSONSchema. ").append(e.what()),
+                snowcrash::ApplicationError,
+                payload.sourceMap->sourceMap));
+        }
+
+        return assets;
+    }
+
     refract::IElement* PayloadToRefract(const NodeInfo<snowcrash::Payload>& payload,
         const NodeInfo<snowcrash::Action>& action,
         ConversionContext& context)
@@ -298,53 +403,105 @@ namespace drafter
         content.push_back(CopyToRefract(MAKE_NODE_INFO(payload, description)));
         content.push_back(DataStructureToRefract(MAKE_NODE_INFO(payload, attributes), context));
 
-        // FIXME: This whole rendering should be done after converting to refract. Currently, both
-        // the renders will do MSONToRefract individually on the same thing. So, basically, the attributes
-        // in a payload gets converted to refract 3 times which is something we should fix.
-        try {
-            // Render using boutique
-            NodeInfoByValue<snowcrash::Asset> payloadBody = renderPayloadBody(payload, action, context);
-            NodeInfoByValue<snowcrash::Asset> payloadSchema = renderPayloadSchema(payload, action, context);
+        if (context.options.renderThreads > 1 && !context.options.lazyRender) {
+            // payload is rendered later by RunRenderJobs()
+            RenderJob job;
+            job.payload = element;
+            job.warnings = context.warnings.size();
+            job.render = [payload, action](ConversionContext& worker) {
+                return PayloadAssetsToRefract(payload, action, worker);
+            };
 
-            // Get content type
-            std::string contentType = getContentTypeFromHeaders(payload.node->headers);
-            std::string schemaContentType
-                = snowcrash::RegexMatch(contentType, JSONRegex) ? JSONSchemaContentType : contentType;
+            context.renderJobs.push_back(std::move(job));
+        } else {
+            const size_t pending = context.pendingAssets.size();
 
-            // Push Body Asset
-            content.push_back(
-                AssetToRefract(NodeInfo<snowcrash::Asset>(payloadBody), contentType, SerializeKey::MessageBody));
+            RefractElements assets = PayloadAssetsToRefract(payload, action, context);
+            content.insert(content.end(), assets.begin(), assets.end());
 
-            // Render only if Body is JSON or Schema is defined
-            if (!payloadSchema.first.empty()) {
-                content.push_back(AssetToRefract(
-                    NodeInfo<snowcrash::Asset>(payloadSchema), schemaContentType, SerializeKey::MessageBodySchema));
+            for (auto it = context.pendingAssets.begin() + pending; it != context.pendingAssets.end(); ++it) {
+                it->payload = element;
+                it->sourceMap = payload.sourceMap->sourceMap;
             }
         }
 
-        // what to do?
-        // we are not able to generate JSON and/or JSON Schema
-        // this is not fatal, rethrow will finish conversion
-
-        // ideal solution is add warning into collection
-        // but there is no way how to do it
-        // in current time we solve it by rethrow
-        catch (snowcrash::Error& e) {
-            context.warn(snowcrash::Warning("unable to render JSON/JSONSchema. " + e.message,
-                snowcrash::ApplicationError,
-                payload.sourceMap->sourceMap));
-        } catch (refract::LogicError& e) {
-            context.warn(snowcrash::Warning(std::string("unable to render JSON/JSONSchema. ").append(e.what()),
-                snowcrash::ApplicationError,
-                payload.sourceMap->sourceMap));
-        }
-
         RemoveEmptyElements(content);
         element->set(content);
 
         return element;
     }
 
+    void RunRenderJobs(ConversionContext& context)
+    {
+        RenderJobs jobs;
+        jobs.swap(context.renderJobs);
+
+        if (jobs.empty()) {
+            return;
+        }
+
+        snowcrash::ProfileScope scope(snowcrash::RenderBodyStage);
+
+        const unsigned threads = TaskThreads(jobs.size(), context.options.renderThreads);
+
+        // every thread renders with its own caches, named types registry is read only now
+        std::vector<std::unique_ptr<ConversionContext> > workers;
+
+        for (unsigned i = 0; i < threads; ++i) {
+            workers.push_back(context.CreateWorker());
+        }
+
+        ThreadProfiles profiles(threads, snowcrash::RenderBodyStage);
+
+        std::vector<RefractElements> assets(jobs.size());
+        std::vector<snowcrash::Warnings> warnings(jobs.size());
+        std::exception_ptr failure;
+
+        try {
+            RunTasks(jobs.size(), threads, [&](size_t task, unsigned thread) {
+                ConversionContext& worker = *workers[thread];
+                snowcrash::ProfileSession session(profiles.get(thread));
+                refract::SymbolScope symbols(&worker.GetSymbolTable());
+
+                worker.warnings.clear();
+                assets[task] = jobs[task].render(worker);
+                warnings[task].swap(worker.warnings);
+            });
+        } catch (...) {
+            failure = std::current_exception();
+        }
+
+        // stitch in document order, warnings of job go right after these issued before the job
+        snowcrash::Warnings issued;
+        issued.swap(context.warnings);
+
+        snowcrash::Warnings::const_iterator next = issued.begin();
+
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            for (; next != issued.begin() + jobs[i].warnings; ++next) {
+                context.warn(*next);
+            }
+
+            for (auto& warning : warnings[i]) {
+                context.warn(warning);
+            }
+
+            for (auto& asset : assets[i]) {
+                if (asset) {
+                    jobs[i].payload->push_back(asset);
+                }
+            }
+        }
+
+        for (; next != issued.end(); ++next) {
+            context.warn(*next);
+        }
+
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    }
+
     refract::IElement* TransactionToRefract(const NodeInfo<snowcrash::TransactionExample>& transaction,
         const NodeInfo<snowcrash::Action>& action,
         const NodeInfo<snowcrash::Request>& request,
@@ -368,6 +525,10 @@ namespace drafter
 
     refract::IElement* ActionToRefract(const NodeInfo<snowcrash::Action>& action, ConversionContext& context)
     {
+        snowcrash::TraceScope trace("action",
+            action.node->name.empty() ? action.node->method : action.node->name,
+            action.sourceMap->sourceMap);
+
         refract::ArrayElement* element = new refract::ArrayElement;
         RefractElements content;
 
@@ -445,6 +606,8 @@ namespace drafter
 
     refract::IElement* ResourceToRefract(const NodeInfo<snowcrash::Resource>& resource, ConversionContext& context)
     {
+        snowcrash::TraceScope trace("resource", resource.node->uriTemplate, resource.sourceMap->sourceMap);
+
         refract::ArrayElement* element = new refract::ArrayElement;
         RefractElements content;
 
@@ -478,10 +641,12 @@ namespace drafter
             &element.sourceMap->content.elements();
     }
 
-    refract::IElement* CategoryToRefract(const NodeInfo<snowcrash::Element>& element, ConversionContext& context)
+    /**
+     * Category without its elements
+     */
+    refract::ArrayElement* EmptyCategoryToRefract(const NodeInfo<snowcrash::Element>& element)
     {
         refract::ArrayElement* category = new refract::ArrayElement;
-        RefractElements content;
 
         category->element(SerializeKey::Category);
 
@@ -492,6 +657,16 @@ namespace drafter
             category->meta[SerializeKey::Classes] = CreateArrayElement(SerializeKey::DataStructures);
         }
 
+        return category;
+    }
+
+    refract::IElement* CategoryToRefract(const NodeInfo<snowcrash::Element>& element, ConversionContext& context)
+    {
+        snowcrash::TraceScope trace("category", element.node->attributes.name, element.sourceMap->sourceMap);
+
+        refract::ArrayElement* category = EmptyCategoryToRefract(element);
+        RefractElements content;
+
         if (!element.node->content.elements().empty()) {
             const NodeInfo<snowcrash::Elements> elementsNodeInfo
                 = MakeNodeInfo(&element.node->content.elements(), GetElementChildrenSourceMap(element));
@@ -525,6 +700,138 @@ namespace drafter
         }
     }
 
+    /**
+     * Element converted on worker thread, with everything it left in worker's context
+     */
+    struct ConvertedElement {
+        std::unique_ptr<refract::IElement> element;
+        snowcrash::Warnings warnings;
+        PendingAssets pendingAssets;
+        RenderJobs renderJobs;
+        std::exception_ptr failure;
+    };
+
+    /**
+     * Convert elements of blueprint concurrently, see `WrapperOptions::convertThreads`
+     *
+     * Elements of categories are converted as separate tasks, so a large resource group
+     * is spread over threads as well. Result and warnings are the same as of sequential
+     * conversion by ElementToRefract(). Elements are owned here until they are put
+     * into `content`, so they are released if conversion of any of them fails.
+     */
+    void ElementsToRefractConcurrently(
+        const NodeInfo<snowcrash::Elements>& elements, RefractElements& content, ConversionContext& context)
+    {
+        NodeInfoCollection<snowcrash::Elements> items(elements);
+
+        std::vector<NodeInfo<snowcrash::Element> > tasks;
+        std::vector<const NodeInfo<snowcrash::Element>*> owners;         // category of task, NULL for item as whole
+        std::vector<std::unique_ptr<refract::ArrayElement> > categories; // NULL for item converted as whole
+        std::vector<size_t> ends;                                        // end of tasks of item
+
+        for (auto& item : items) {
+            if (item.node->element == snowcrash::Element::CategoryElement) {
+                categories.emplace_back(EmptyCategoryToRefract(item));
+
+                if (!item.node->content.elements().empty()) {
+                    NodeInfoCollection<snowcrash::Elements> children(
+                        MakeNodeInfo(&item.node->content.elements(), GetElementChildrenSourceMap(item)));
+                    tasks.insert(tasks.end(), children.begin(), children.end());
+                    owners.resize(tasks.size(), &item);
+                }
+            } else {
+                categories.emplace_back();
+                tasks.push_back(item);
+                owners.push_back(NULL);
+            }
+
+            ends.push_back(tasks.size());
+        }
+
+        const unsigned threads = TaskThreads(tasks.size(), context.options.convertThreads);
+
+        // named types are registered already, registry is read only now
+        std::vector<std::unique_ptr<ConversionContext> > workers;
+
+        for (unsigned i = 0; i < threads; ++i) {
+            workers.push_back(context.CreateWorker());
+        }
+
+        ThreadProfiles profiles(threads, snowcrash::RefractStage);
+
+        std::vector<ConvertedElement> results(tasks.size());
+
+        RunTasks(tasks.size(), threads, [&](size_t task, unsigned thread) {
+            ConversionContext& worker = *workers[thread];
+            ConvertedElement& result = results[task];
+            snowcrash::ProfileSession session(profiles.get(thread));
+            refract::SymbolScope symbols(&worker.GetSymbolTable());
+
+            try {
+                // elements of category are converted apart, each of them is traced within the category
+                std::unique_ptr<snowcrash::TraceScope> trace;
+
+                if (const NodeInfo<snowcrash::Element>* category = owners[task]) {
+                    trace.reset(new snowcrash::TraceScope(
+                        "category", category->node->attributes.name, category->sourceMap->sourceMap));
+                }
+
+                result.element.reset(ElementToRefract(tasks[task], worker));
+            } catch (...) {
+                result.failure = std::current_exception();
+            }
+
+            result.warnings.swap(worker.warnings);
+            result.pendingAssets.swap(worker.pendingAssets);
+            result.renderJobs.swap(worker.renderJobs);
+        });
+
+        // merge in document order, as if converted sequentially
+        for (auto& result : results) {
+            RenderJobs::iterator job = result.renderJobs.begin();
+
+            for (size_t i = 0; i < result.warnings.size(); ++i) {
+                for (; job != result.renderJobs.end() && job->warnings == i; ++job) {
+                    job->warnings = context.warnings.size();
+                }
+
+                context.warn(result.warnings[i]);
+            }
+
+            for (; job != result.renderJobs.end(); ++job) {
+                job->warnings = context.warnings.size();
+            }
+
+            std::move(result.renderJobs.begin(), result.renderJobs.end(), std::back_inserter(context.renderJobs));
+            std::move(
+                result.pendingAssets.begin(), result.pendingAssets.end(), std::back_inserter(context.pendingAssets));
+
+            if (result.failure) {
+                std::rethrow_exception(result.failure);
+            }
+        }
+
+        size_t task = 0;
+
+        for (size_t i = 0; i < categories.size(); ++i) {
+            if (!categories[i]) {
+                content.push_back(results[task++].element.release());
+                continue;
+            }
+
+            RefractElements categoryContent;
+
+            for (; task < ends[i]; ++task) {
+                categoryContent.push_back(results[task].element.release());
+            }
+
+            RemoveEmptyElements(categoryContent);
+            categories[i]->set(categoryContent);
+
+            content.push_back(categories[i].release());
+        }
+    }
+
     refract::IElement* BlueprintToRefract(const NodeInfo<snowcrash::Blueprint>& blueprint, ConversionContext& context)
     {
         refract::ArrayElement* ast = new refract::ArrayElement;
@@ -542,11 +849,17 @@ namespace drafter
                 MAKE_NODE_INFO(blueprint, metadata), context, MetadataToRefract);
         }
 
-        NodeInfoToElements(MAKE_NODE_INFO(blueprint, content.elements()), ElementToRefract, content, context);
+        if (context.options.convertThreads > 1) {
+            ElementsToRefractConcurrently(MAKE_NODE_INFO(blueprint, content.elements()), content, context);
+        } else {
+            NodeInfoToElements(MAKE_NODE_INFO(blueprint, content.elements()), ElementToRefract, content, context);
+        }
 
         RemoveEmptyElements(content);
         ast->set(content);
 
+        RunRenderJobs(context);
+
         return ast;
     }
 
@@ -19,6 +19,11 @@
 #include "ConversionContext.h"
 
 #include "ElementData.h"
+#include "Profile.h"
+#include "TaskPool.h"
+
+#include <algorithm>
+#include <memory>
 
 namespace drafter
 {
@@ -401,14 +406,7 @@ namespace drafter
 
     static mson::BaseTypeName GetMsonTypeFromName(const std::string& name, const ConversionContext& context)
     {
-        refract::IElement* e = FindRootAncestor(name, context.GetNamedTypesRegistry());
-        if (!e) {
-            return mson::UndefinedTypeName;
-        }
-
-        refract::TypeQueryVisitor query;
-        refract::VisitBy(*e, query);
-        return RefractElementTypeToMsonType(query.get());
+        return RefractElementTypeToMsonType(context.GetNamedTypesRegistry().findRootType(name));
     }
 
     /**
@@ -972,12 +970,8 @@ namespace drafter
             return true;
         }
 
-        if (refract::TypeQueryVisitor::as<refract::StringElement>(FindRootAncestor(
-                variable.typeDefinition.typeSpecification.name.symbol.literal, context.GetNamedTypesRegistry()))) {
-            return true;
-        }
-
-        return false;
+        const std::string& name = variable.typeDefinition.typeSpecification.name.symbol.literal;
+        return context.GetNamedTypesRegistry().findRootType(name) == refract::TypeQueryVisitor::String;
     }
 
     refract::IElement* GetPropertyKey(const NodeInfo<mson::PropertyMember>& property, ConversionContext& context)
@@ -1366,6 +1360,8 @@ namespace drafter
             return element;
         }
 
+        snowcrash::ProfileScope scope(snowcrash::ExpandStage);
+
         refract::ExpandVisitor expander(context.GetNamedTypesRegistry());
         refract::Visit(expander, *element);
 
@@ -1377,12 +1373,207 @@ namespace drafter
         return element;
     }
 
+    namespace
+    {
+        /**
+         * Rough estimate of size of serialized element
+         *
+         * Walk stops once `limit` is reached, so large trees are not walked whole.
+         */
+        struct SerializedSizeEstimate {
+            size_t size;
+            const size_t limit;
+
+            SerializedSizeEstimate(size_t limit) : size(0), limit(limit) {}
+
+            void add(const refract::IElement* e)
+            {
+                if (!e || size >= limit) {
+                    return;
+                }
+
+                // keys and punctuation of "element", "meta", "attributes" and "content"
+                size += 48 + e->element().size();
+
+                add(e->meta);
+                add(e->attributes);
+
+                if (!e->empty()) {
+                    refract::VisitBy(*e, *this);
+                }
+            }
+
+            void add(const refract::IElement::MemberElementCollection& collection)
+            {
+                for (auto& member : collection) {
+                    add(member);
+                }
+            }
+
+            void operator()(const refract::IElement& e) {}
+
+            template <typename T>
+            void operator()(const T& e)
+            {
+                addValue(e.value);
+            }
+
+            void addValue(const std::string& value)
+            {
+                size += value.size();
+            }
+
+            void addValue(double)
+            {
+                size += 8;
+            }
+
+            void addValue(bool)
+            {
+                size += 5;
+            }
+
+            void addValue(const refract::NullElement::ValueType&)
+            {
+                size += 4;
+            }
+
+            void addValue(const refract::IElement* value)
+            {
+                add(value);
+            }
+
+            void addValue(const refract::MemberElement::ValueType& value)
+            {
+                add(value.first);
+                add(value.second);
+            }
+
+            template <typename T>
+            void addValue(const std::vector<T*>& values)
+            {
+                for (auto& value : values) {
+                    add(value);
+                }
+            }
+        };
+
+        sos::Object SerializeElement(const refract::IElement& element, bool generateSourceMap)
+        {
+            refract::SosSerializeVisitor serializer(generateSourceMap);
+            refract::Visit(serializer, element);
+
+            return serializer.get();
+        }
+
+        /**
+         * Move serialized value into `to`
+         *
+         * sos::Base can only be copied, which copies the whole subtree, so its
+         * parts are swapped instead.
+         */
+        void MoveSerialized(sos::Base& to, sos::Base& from)
+        {
+            to.type = from.type;
+            to.str.swap(from.str);
+            to.number = from.number;
+            to.boolean = from.boolean;
+            to.array.swap(from.array);
+            to.keys.swap(from.keys);
+            to.object().swap(from.object());
+        }
+
+        /**
+         * Serialize array element with `size` empty slots for its content
+         *
+         * Returns the slots, which are serialized into later.
+         */
+        sos::Bases& SerializeArrayWithSlots(
+            sos::Base& to, const refract::ArrayElement& element, size_t size, bool generateSourceMap)
+        {
+            std::unique_ptr<refract::IElement> empty(
+                element.clone(refract::IElement::cAll ^ refract::IElement::cValue));
+
+            sos::Object object = SerializeElement(*empty, generateSourceMap);
+            object.set("content", sos::Array());
+            MoveSerialized(to, object);
+
+            sos::Bases& content = to.object()["content"].array;
+            content.resize(size);
+
+            return content;
+        }
+
+        /**
+         * Serialize large parse result on more threads
+         *
+         * Children of parse result and elements of its categories are serialized
+         * as separate tasks, each straight into its slot of the resulting tree, so
+         * the result is the same as of SosSerializeVisitor over the whole tree.
+         * Only the tree is built on more threads, the text is written from it by
+         * sos serializer on one thread.
+         */
+        sos::Object SerializeConcurrently(
+            const refract::ArrayElement& parseResult, bool generateSourceMap, unsigned threads)
+        {
+            std::vector<const refract::IElement*> tasks;
+            std::vector<sos::Base*> slots;
+
+            sos::Object result;
+            sos::Bases& content
+                = SerializeArrayWithSlots(result, parseResult, parseResult.value.size(), generateSourceMap);
+
+            for (size_t i = 0; i < parseResult.value.size(); ++i) {
+                const refract::IElement* child = parseResult.value[i];
+                const refract::ArrayElement* category = refract::TypeQueryVisitor::as<refract::ArrayElement>(child);
+
+                if (category && !category->empty() && !category->value.empty()
+                    && category->element() == SerializeKey::Category) {
+
+                    sos::Bases& categoryContent
+                        = SerializeArrayWithSlots(content[i], *category, category->value.size(), generateSourceMap);
+
+                    for (size_t j = 0; j < category->value.size(); ++j) {
+                        tasks.push_back(category->value[j]);
+                        slots.push_back(&categoryContent[j]);
+                    }
+                } else {
+                    tasks.push_back(child);
+                    slots.push_back(&content[i]);
+                }
+            }
+
+            threads = TaskThreads(tasks.size(), threads);
+            ThreadProfiles profiles(threads, snowcrash::SerializeStage);
+
+            RunTasks(tasks.size(), threads, [&](size_t task, unsigned thread) {
+                snowcrash::ProfileSession session(profiles.get(thread));
+                sos::Object serialized = SerializeElement(*tasks[task], generateSourceMap);
+                MoveSerialized(*slots[task], serialized);
+            });
+
+            return result;
+        }
+    }
+
     sos::Object SerializeRefract(refract::IElement* element, ConversionContext& context)
     {
         if (!element) {
             return sos::Object();
         }
 
+        const WrapperOptions& options = context.options;
+        const refract::ArrayElement* parseResult = refract::TypeQueryVisitor::as<refract::ArrayElement>(element);
+
+        if (options.serializeThreads > 1 && parseResult && !parseResult->empty()) {
+            SerializedSizeEstimate estimate(options.concurrentSize);
+            estimate.add(parseResult);
+
+            if (estimate.size >= options.concurrentSize) {
+                return SerializeConcurrently(*parseResult, options.generateSourceMap, options.serializeThreads);
+            }
+        }
+
         refract::SosSerializeVisitor serializer(context.options.generateSourceMap);
         refract::Visit(serializer, *element);
 
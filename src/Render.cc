@@ -11,30 +11,125 @@
 
 #include "SourceAnnotation.h"
 #include "BlueprintUtility.h"
-#include "RegexMatch.h"
+#include "Profile.h"
 
 #include "ConversionContext.h"
 
 #include "refract/RenderJSONVisitor.h"
 #include "refract/JSONSchemaVisitor.h"
 
+#include <cstring>
+
 using namespace snowcrash;
 
 namespace drafter
 {
 
+    namespace
+    {
+        const std::string ApplicationType = "application/";
+        const std::string JSONSchemaSubtype = "schema+json";
+        const std::string JSONSubtype = "json";
+
+        bool IsBlank(char c)
+        {
+            return c == ' ' || c == '\t';
+        }
+
+        /**
+         * Subtype ends at `pos`, only parameters follow - `[[:blank:]]*(;.*|$)`
+         */
+        bool IsSubtypeEnd(const std::string& subtype, std::string::size_type pos)
+        {
+            while (pos < subtype.size() && IsBlank(subtype[pos])) {
+                ++pos;
+            }
+
+            return pos == subtype.size() || subtype[pos] == ';';
+        }
+
+        std::string RenderBody(
+            const refract::IElement& expanded, RenderFormat renderFormat, refract::JSONSchemaCache* cache)
+        {
+            switch (renderFormat) {
+                case JSONRenderFormat: {
+                    refract::RenderJSONVisitor renderer;
+                    refract::Visit(renderer, expanded);
+
+                    return renderer.getString();
+                }
+
+                case JSONSchemaRenderFormat: {
+                    refract::JSONSchemaVisitor renderer(NULL, false, false, cache);
+                    return renderer.getSchema(expanded);
+                }
+
+                case UndefinedRenderFormat:
+                    break;
+            }
+
+            throw snowcrash::Error("unknown content type for messageBody to be rendered", snowcrash::ApplicationError);
+        }
+
+        std::string RenderSchema(const refract::IElement& expanded, refract::JSONSchemaCache* cache)
+        {
+            refract::JSONSchemaVisitor renderer(NULL, false, false, cache);
+            return renderer.getSchema(expanded);
+        }
+    }
+
     RenderFormat findRenderFormat(const std::string& contentType)
     {
+        // regex matching stops at the first NUL
+        const char* type = contentType.c_str();
+        const size_t length = std::strlen(type);
+
+        size_t pos = 0;
+
+        while (pos < length && IsBlank(type[pos])) {
+            ++pos;
+        }
 
-        if (RegexMatch(contentType, JSONSchemaRegex)) {
+        if (length - pos < ApplicationType.size()
+            || ApplicationType.compare(0, std::string::npos, type + pos, ApplicationType.size()) != 0) {
+            return UndefinedRenderFormat;
+        }
+
+        pos += ApplicationType.size();
+
+        const std::string subtype(type + pos, length - pos);
+
+        if (subtype.compare(0, JSONSchemaSubtype.size(), JSONSchemaSubtype) == 0
+            && IsSubtypeEnd(subtype, JSONSchemaSubtype.size())) {
             return JSONSchemaRenderFormat;
-        } else if (RegexMatch(contentType, JSONRegex)) {
-            return JSONRenderFormat;
+        }
+
+        // "json" alone or as suffix of structured syntax, e.g. "hal+json"
+        for (std::string::size_type json = subtype.find(JSONSubtype); json != std::string::npos;
+             json = subtype.find(JSONSubtype, json + 1)) {
+
+            if ((json == 0 || subtype[json - 1] == '+') && IsSubtypeEnd(subtype, json + JSONSubtype.size())) {
+                return JSONRenderFormat;
+            }
         }
 
         return UndefinedRenderFormat;
     }
 
+    RenderFormat RenderFormatCache::find(const std::string& contentType)
+    {
+        std::unordered_map<std::string, RenderFormat>::const_iterator i = formats.find(contentType);
+
+        if (i != formats.end()) {
+            return i->second;
+        }
+
+        RenderFormat renderFormat = findRenderFormat(contentType);
+        formats.emplace(contentType, renderFormat);
+
+        return renderFormat;
+    }
+
     std::string getContentTypeFromHeaders(const Headers& headers)
     {
         Collection<Header>::const_iterator header;
@@ -50,8 +145,10 @@ namespace drafter
         return "";
     }
 
-    NodeInfoByValue<Asset> renderPayloadBody(
-        const NodeInfo<Payload>& payload, const NodeInfo<Action>& action, ConversionContext& context)
+    NodeInfoByValue<Asset> renderPayloadBody(const NodeInfo<Payload>& payload,
+        const NodeInfo<Action>& action,
+        RenderFormat renderFormat,
+        ConversionContext& context)
     {
 
         NodeInfoByValue<Asset> body = std::make_pair(payload.node->body, &payload.sourceMap->body);
@@ -66,13 +163,13 @@ namespace drafter
             attributes = &actionAttributes;
         }
 
-        RenderFormat renderFormat = findRenderFormat(getContentTypeFromHeaders(payload.node->headers));
-
         // Only continue down if we have a render format
         if (!payload.node->body.empty() || attributes->node->empty() || renderFormat == UndefinedRenderFormat) {
             return body;
         }
 
+        ProfileScope scope(RenderBodyStage);
+
         // Expand MSON into Refract
         refract::IElement* element = MSONToRefract(*attributes, context);
 
@@ -86,36 +183,15 @@ namespace drafter
             return body;
         }
 
-        // One of this will always execute since we have a catch above for not having render format
-        switch (renderFormat) {
-            case JSONRenderFormat: {
-                refract::RenderJSONVisitor renderer;
-                refract::Visit(renderer, *expanded);
-
-                delete expanded;
-
-                return std::make_pair(renderer.getString(), NodeInfo<Asset>::NullSourceMap());
-            }
-
-            case JSONSchemaRenderFormat: {
-                refract::JSONSchemaVisitor renderer;
-                std::string result = renderer.getSchema(*expanded);
-
-                delete expanded;
-
-                return std::make_pair(result, NodeInfo<Asset>::NullSourceMap());
-            }
-
-            case UndefinedRenderFormat:
-                break;
-        }
+        std::string result = RenderBody(*expanded, renderFormat, &context.GetJSONSchemaCache());
+        delete expanded;
 
-        // Throw exception
-        throw snowcrash::Error("unknown content type for messageBody to be rendered", snowcrash::ApplicationError);
+        return std::make_pair(Asset(std::move(result)), NodeInfo<Asset>::NullSourceMap());
     }
 
     NodeInfoByValue<Asset> renderPayloadSchema(const NodeInfo<snowcrash::Payload>& payload,
         const NodeInfo<snowcrash::Action>& action,
+        RenderFormat renderFormat,
         ConversionContext& context)
     {
 
@@ -133,12 +209,13 @@ namespace drafter
 
         // Generate Schema only if Body content type is JSON
         if (!payload.node->schema.empty() || payload.node->attributes.empty()
-            || findRenderFormat(getContentTypeFromHeaders(payload.node->headers)) != JSONRenderFormat) {
+            || renderFormat != JSONRenderFormat) {
 
             return schema;
         }
 
-        refract::JSONSchemaVisitor renderer;
+        ProfileScope scope(RenderSchemaStage);
+
         refract::IElement* element = MSONToRefract(*attributes, context);
 
         if (!element) {
@@ -151,9 +228,69 @@ namespace drafter
             return schema;
         }
 
-        std::string result = renderer.getSchema(*expanded);
+        std::string result = RenderSchema(*expanded, &context.GetJSONSchemaCache());
         delete expanded;
 
-        return std::make_pair(result, NodeInfo<Asset>::NullSourceMap());
+        return std::make_pair(Asset(std::move(result)), NodeInfo<Asset>::NullSourceMap());
+    }
+
+    DeferredPayloadRender deferPayloadRender(const NodeInfo<snowcrash::Payload>& payload,
+        const NodeInfo<snowcrash::Action>& action,
+        RenderFormat renderFormat,
+        ConversionContext& context)
+    {
+        DeferredPayloadRender render;
+
+        NodeInfo<Attributes> payloadAttributes = MAKE_NODE_INFO(payload, attributes);
+        NodeInfo<Attributes> actionAttributes = MAKE_NODE_INFO(action, attributes);
+
+        // hold attributes via pointer - because problems with assignment in NodeInfo<>
+        NodeInfo<Attributes>* attributes = &payloadAttributes;
+
+        if (payload.node->attributes.empty() && !action.isNull() && !action.node->attributes.empty()) {
+            attributes = &actionAttributes;
+        }
+
+        // same conditions as in renderPayloadBody() and renderPayloadSchema()
+        bool body = payload.node->body.empty() && !attributes->node->empty() && renderFormat != UndefinedRenderFormat;
+        bool schema
+            = payload.node->schema.empty() && !payload.node->attributes.empty() && renderFormat == JSONRenderFormat;
+
+        if (!body && !schema) {
+            return render;
+        }
+
+        ProfileScope scope(RenderBodyStage);
+
+        refract::IElement* element = MSONToRefract(*attributes, context);
+
+        if (!element) {
+            return render;
+        }
+
+        // body and schema are rendered from one expanded element
+        std::shared_ptr<const refract::IElement> expanded(ExpandRefract(element, context));
+
+        if (!expanded) {
+            return render;
+        }
+
+        std::shared_ptr<refract::JSONSchemaCache> cache = context.ShareJSONSchemaCache();
+
+        if (body) {
+            render.body = [expanded, renderFormat, cache]() {
+                ProfileScope scope(RenderBodyStage);
+                return RenderBody(*expanded, renderFormat, cache.get());
+            };
+        }
+
+        if (schema) {
+            render.schema = [expanded, cache]() {
+                ProfileScope scope(RenderSchemaStage);
+                return RenderSchema(*expanded, cache.get());
+            };
+        }
+
+        return render;
     }
 }
@@ -10,6 +10,8 @@
 #define DRAFTER_RENDER_H
 
 #include "Serialize.h"
+#include <unordered_map>
+#include <functional>
 
 namespace drafter
 {
@@ -27,15 +29,48 @@ namespace drafter
 
     class ConversionContext;
 
+    /**
+     * Parses media type of content type, same as matching `JSONSchemaRegex` and `JSONRegex`
+     */
     RenderFormat findRenderFormat(const std::string& contentType);
     std::string getContentTypeFromHeaders(const snowcrash::Headers& headers);
 
+    /**
+     * Render formats of distinct content types used in document
+     */
+    class RenderFormatCache
+    {
+        std::unordered_map<std::string, RenderFormat> formats;
+
+    public:
+        RenderFormat find(const std::string& contentType);
+    };
+
     NodeInfoByValue<snowcrash::Asset> renderPayloadBody(const NodeInfo<snowcrash::Payload>& payload,
         const NodeInfo<snowcrash::Action>& action,
+        RenderFormat renderFormat,
         ConversionContext& context);
 
     NodeInfoByValue<snowcrash::Asset> renderPayloadSchema(const NodeInfo<snowcrash::Payload>& payload,
         const NodeInfo<snowcrash::Action>& action,
+        RenderFormat renderFormat,
+        ConversionContext& context);
+
+    /**
+     * Deferred rendering of payload body and schema
+     *
+     * MSON attributes are converted and expanded immediately, so the
+     * conversion reports its annotations as usual, only rendering is
+     * deferred. Empty function means there is nothing to render.
+     */
+    struct DeferredPayloadRender {
+        std::function<std::string()> body;
+        std::function<std::string()> schema;
+    };
+
+    DeferredPayloadRender deferPayloadRender(const NodeInfo<snowcrash::Payload>& payload,
+        const NodeInfo<snowcrash::Action>& action,
+        RenderFormat renderFormat,
         ConversionContext& context);
 }
 
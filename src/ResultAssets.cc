@@ -0,0 +1,87 @@
+//
+//  ResultAssets.cc
+//  drafter
+//
+#include "ResultAssets.h"
+
+#include "Serialize.h"
+#include "refract/Element.h"
+#include "refract/Exception.h"
+
+#include <algorithm>
+
+namespace
+{
+    void RemoveElement(refract::ArrayElement* payload, const refract::IElement* element)
+    {
+        auto& value = payload->value;
+        auto it = std::find(value.begin(), value.end(), element);
+
+        if (it != value.end()) {
+            delete *it;
+            value.erase(it);
+        }
+    }
+
+    void RemoveAssets(refract::ArrayElement* payload)
+    {
+        auto& value = payload->value;
+        auto assets = std::stable_partition(value.begin(), value.end(), [](const refract::IElement* element) {
+            return element->element() != drafter::SerializeKey::Asset;
+        });
+
+        for (auto it = assets; it != value.end(); ++it) {
+            delete *it;
+        }
+
+        value.erase(assets, value.end());
+    }
+}
+
+void drafter::RenderPendingAssets(PendingAssets& assets, snowcrash::Warnings& warnings)
+{
+    auto group = assets.begin();
+
+    // assets of one payload are pending next to each other
+    while (group != assets.end()) {
+        refract::ArrayElement* payload = group->payload;
+        auto end = std::find_if(
+            group, assets.end(), [payload](const PendingAsset& pending) { return pending.payload != payload; });
+
+        std::vector<std::string> contents;
+        std::string failure;
+        bool failed = false;
+
+        try {
+            for (auto it = group; it != end; ++it) {
+                contents.push_back(it->render());
+            }
+        } catch (snowcrash::Error& e) {
+            failure = e.message;
+            failed = true;
+        } catch (refract::LogicError& e) {
+            failure = e.what();
+            failed = true;
+        }
+
+        if (failed) {
+            warnings.push_back(snowcrash::Warning(
+                "unable to render JSON/JSONSchema. " + failure, snowcrash::ApplicationError, group->sourceMap));
+            RemoveAssets(payload);
+        } else {
+            for (auto it = group; it != end; ++it) {
+                const std::string& content = contents[it - group];
+
+                if (content.empty()) {
+                    RemoveElement(payload, it->asset);
+                } else {
+                    it->asset->set(content);
+                }
+            }
+        }
+
+        group = end;
+    }
+
+    assets.clear();
+}
@@ -0,0 +1,53 @@
+//
+//  ResultAssets.h
+//  drafter
+//
+#ifndef DRAFTER_RESULTASSETS_H
+#define DRAFTER_RESULTASSETS_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "ByteBuffer.h"
+#include "SourceAnnotation.h"
+
+#include "refract/ElementFwd.h"
+
+namespace drafter
+{
+
+    /**
+     * Asset element waiting for its content to be rendered
+     */
+    struct PendingAsset {
+        refract::StringElement* asset;
+        std::function<std::string()> render;
+
+        /** HTTP request or response the asset is content of */
+        refract::ArrayElement* payload;
+
+        /** Source map of the payload, location of warning if render fails */
+        mdp::BytesRangeSet sourceMap;
+    };
+
+    typedef std::vector<PendingAsset> PendingAssets;
+
+    /**
+     * Annotation elements of parse result in order of the result,
+     * elements are owned by the result
+     */
+    typedef std::vector<const refract::IElement*> Annotations;
+
+    /**
+     *  \brief Render content of pending assets, `assets` are left empty
+     *
+     *  Result is the same as if assets were rendered during conversion:
+     *  asset rendered empty is removed from its payload, if any asset of
+     *  a payload fails to render, no asset of the payload is kept and
+     *  the failure is appended to `warnings`.
+     */
+    void RenderPendingAssets(PendingAssets& assets, snowcrash::Warnings& warnings);
+}
+
+#endif // #ifndef DRAFTER_RESULTASSETS_H
@@ -44,15 +44,58 @@ namespace drafter
     struct WrapperOptions {
         const bool generateSourceMap;
         const bool expandMSON;
-
-        WrapperOptions(const bool generateSourceMap, const bool expandMSON)
-            : generateSourceMap(generateSourceMap), expandMSON(expandMSON)
+        const bool schemaReferences;
+        const bool lazyRender;           // render message bodies and schemas on serialization
+        const unsigned renderThreads;    // render message bodies and schemas on more threads if > 1
+        const unsigned convertThreads;   // convert resource groups on more threads if > 1
+        const unsigned serializeThreads; // serialize large results on more threads if > 1
+        const size_t concurrentSize;     // estimated serialized size of result large enough for serializeThreads
+
+        /** Default of `concurrentSize` (bytes) */
+        static const size_t DefaultConcurrentSize = 20 * 1024 * 1024;
+
+        WrapperOptions(const bool generateSourceMap,
+            const bool expandMSON,
+            const bool schemaReferences = false,
+            const bool lazyRender = false,
+            const unsigned renderThreads = 0,
+            const unsigned convertThreads = 0,
+            const unsigned serializeThreads = 0,
+            const size_t concurrentSize = DefaultConcurrentSize)
+            : generateSourceMap(generateSourceMap),
+              expandMSON(expandMSON),
+              schemaReferences(schemaReferences),
+              lazyRender(lazyRender),
+              renderThreads(renderThreads),
+              convertThreads(convertThreads),
+              serializeThreads(serializeThreads),
+              concurrentSize(concurrentSize)
         {
         }
 
-        WrapperOptions(const bool generateSourceMap) : generateSourceMap(generateSourceMap), expandMSON(false) {}
+        WrapperOptions(const bool generateSourceMap)
+            : generateSourceMap(generateSourceMap),
+              expandMSON(false),
+              schemaReferences(false),
+              lazyRender(false),
+              renderThreads(0),
+              convertThreads(0),
+              serializeThreads(0),
+              concurrentSize(DefaultConcurrentSize)
+        {
+        }
 
-        WrapperOptions() : generateSourceMap(false), expandMSON(false) {}
+        WrapperOptions()
+            : generateSourceMap(false),
+              expandMSON(false),
+              schemaReferences(false),
+              lazyRender(false),
+              renderThreads(0),
+              convertThreads(0),
+              serializeThreads(0),
+              concurrentSize(DefaultConcurrentSize)
+        {
+        }
     };
 
     /**
@@ -13,6 +13,7 @@
 
 #include "SourceAnnotation.h"
 #include "SectionProcessor.h"
+#include "Profile.h"
 
 #include "refract/Build.h"
 #include "refract/ElementInserter.h"
@@ -41,6 +42,9 @@ namespace helper
 refract::IElement* drafter::WrapRefract(
     snowcrash::ParseResult<snowcrash::Blueprint>& blueprint, ConversionContext& context)
 {
+    // element names are interned per parse
+    refract::SymbolScope symbols(&context.GetSymbolTable());
+
     snowcrash::Error error;
     refract::IElement* blueprintRefract = NULL;
 
@@ -49,8 +53,13 @@ refract::IElement* drafter::WrapRefract(
 
     if (blueprint.report.error.code == snowcrash::Error::OK) {
         try {
-            RegisterNamedTypes(
-                MakeNodeInfo(blueprint.node.content.elements(), blueprint.sourceMap.content.elements()), context);
+            {
+                snowcrash::ProfileScope scope(snowcrash::NamedTypesStage);
+                RegisterNamedTypes(
+                    MakeNodeInfo(blueprint.node.content.elements(), blueprint.sourceMap.content.elements()), context);
+            }
+
+            snowcrash::ProfileScope scope(snowcrash::RefractStage);
             blueprintRefract = BlueprintToRefract(MakeNodeInfo(blueprint.node, blueprint.sourceMap), context);
         } catch (std::exception& e) {
             error = snowcrash::Error(e.what(), snowcrash::MSONError);
@@ -58,10 +67,14 @@ refract::IElement* drafter::WrapRefract(
             error = e;
         }
 
-        context.GetNamedTypesRegistry().clearAll(true);
+        context.GetNamedTypesRegistry().clearAll();
 
         if (error.code != snowcrash::Error::OK) {
             blueprint.report.error = error;
+
+            // elements of failed conversion are dropped, assets left to render into them too
+            context.pendingAssets.clear();
+            context.renderJobs.clear();
         }
 
         if (blueprintRefract) {
@@ -69,6 +82,8 @@ refract::IElement* drafter::WrapRefract(
         }
     }
 
+    const size_t annotationsBegin = parseResult->value.size();
+
     if (blueprint.report.error.code != snowcrash::Error::OK) {
         parseResult->push_back(helper::AnnotationToRefract(SerializeKey::Error)(blueprint.report.error));
     }
@@ -86,5 +101,8 @@ refract::IElement* drafter::WrapRefract(
             helper::AnnotationToRefract(SerializeKey::Warning));
     }
 
+    // annotations are the last elements of parse result
+    context.annotations.assign(parseResult->value.begin() + annotationsBegin, parseResult->value.end());
+
     return parseResult;
 }
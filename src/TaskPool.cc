@@ -0,0 +1,102 @@
+//
+//  TaskPool.cc
+//  drafter
+//
+#include "TaskPool.h"
+
+#include <atomic>
+#include <exception>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+unsigned drafter::TaskThreads(size_t count, unsigned threads)
+{
+    const unsigned hardware = std::thread::hardware_concurrency();
+
+    if (hardware && threads > hardware) {
+        threads = hardware;
+    }
+
+    if (threads > count) {
+        threads = static_cast<unsigned>(count);
+    }
+
+    return threads;
+}
+
+void drafter::RunTasks(size_t count, unsigned threads, const std::function<void(size_t task, unsigned thread)>& task)
+{
+    threads = TaskThreads(count, threads);
+
+    std::atomic<size_t> next(0);
+    std::vector<std::exception_ptr> failures(count);
+
+    auto worker = [&](unsigned thread) {
+        for (size_t i = next++; i < count; i = next++) {
+            try {
+                task(i, thread);
+            } catch (...) {
+                failures[i] = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+
+    if (threads > 1) {
+        pool.reserve(threads - 1);
+    }
+
+    for (unsigned thread = 1; thread < threads; ++thread) {
+        try {
+            pool.emplace_back(worker, thread);
+        } catch (const std::system_error&) {
+            // out of threads, threads started already take over tasks of the rest
+            break;
+        }
+    }
+
+    worker(0);
+
+    for (auto& thread : pool) {
+        thread.join();
+    }
+
+    for (auto& failure : failures) {
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    }
+}
+
+drafter::ThreadProfiles::ThreadProfiles(unsigned threads, snowcrash::ProfileStage stage)
+    : profile(snowcrash::Profile::current())
+{
+    if (!profile) {
+        return;
+    }
+
+    for (unsigned thread = 1; thread < threads; ++thread) {
+        workers.emplace_back(new snowcrash::Profile);
+        workers.back()->trace(profile->tracing());
+        workers.back()->enter(stage);
+    }
+}
+
+drafter::ThreadProfiles::~ThreadProfiles()
+{
+    for (size_t i = 0; i < workers.size(); ++i) {
+        workers[i]->leave();
+        profile->merge(*workers[i], static_cast<unsigned>(i + 1));
+    }
+}
+
+snowcrash::Profile* drafter::ThreadProfiles::get(unsigned thread) const
+{
+    if (!profile || thread == 0) {
+        return profile;
+    }
+
+    return workers[thread - 1].get();
+}
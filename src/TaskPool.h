@@ -0,0 +1,72 @@
+//
+//  TaskPool.h
+//  drafter
+//
+#ifndef DRAFTER_TASKPOOL_H
+#define DRAFTER_TASKPOOL_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "Profile.h"
+
+namespace drafter
+{
+
+    /**
+     *  \brief Number of threads to run `count` tasks on when `threads` are requested
+     *
+     *  Requested threads are limited by the number of tasks and by the number
+     *  of hardware threads, so a bogus request does not start more threads
+     *  than there is use for.
+     */
+    unsigned TaskThreads(size_t count, unsigned threads);
+
+    /**
+     *  \brief Run `count` independent tasks on up to `threads` threads
+     *
+     *  Tasks are taken in order by whichever thread is free, the calling
+     *  thread runs tasks as well. `task` gets index of task and index of
+     *  thread (0 to `threads - 1`) running it, so callers can keep state
+     *  per thread.
+     *
+     *  Threads are limited by `TaskThreads()`. If the system refuses to
+     *  start a thread, tasks are run by threads started already.
+     *
+     *  All tasks are run even if some of them fail. Exception of the
+     *  first failed task, in task order, is rethrown once all threads
+     *  finished.
+     */
+    void RunTasks(size_t count, unsigned threads, const std::function<void(size_t task, unsigned thread)>& task);
+
+    /**
+     *  \brief Profiles of threads running tasks by `RunTasks()`
+     *
+     *  Calling thread (thread 0) records into its own profile, other
+     *  threads into profiles of their own, which are merged into the
+     *  calling thread profile on destruction. Other threads are recorded
+     *  in `stage` while they run, the stage calling thread runs tasks in.
+     *  Task makes profile of its thread the recording one by
+     *  `snowcrash::ProfileSession`.
+     */
+    class ThreadProfiles
+    {
+        snowcrash::Profile* profile;
+        std::vector<std::unique_ptr<snowcrash::Profile> > workers;
+
+        ThreadProfiles(const ThreadProfiles&);
+        ThreadProfiles& operator=(const ThreadProfiles&);
+
+    public:
+        /** Profiles for `threads` threads, none if calling thread does not profile */
+        ThreadProfiles(unsigned threads, snowcrash::ProfileStage stage);
+        ~ThreadProfiles();
+
+        /** \brief Profile of given thread, NULL if calling thread does not profile */
+        snowcrash::Profile* get(unsigned thread) const;
+    };
+}
+
+#endif // #ifndef DRAFTER_TASKPOOL_H
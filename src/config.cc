@@ -24,6 +24,12 @@ namespace config
     static const std::string Validate = "validate";
     static const std::string Version = "version";
     static const std::string UseLineNumbers = "use-line-num";
+    static const std::string Profile = "profile";
+    static const std::string Trace = "trace";
+    static const std::string SchemaReferences = "schema-refs";
+    static const std::string RenderThreads = "render-threads";
+    static const std::string ConvertThreads = "convert-threads";
+    static const std::string SerializeThreads = "serialize-threads";
 };
 
 void PrepareCommanLineParser(cmdline::parser& parser)
@@ -43,6 +49,15 @@ void PrepareCommanLineParser(cmdline::parser& parser)
     parser.add(config::Validate, 'l', "validate input only, do not output Parse Result");
     parser.add(
         config::UseLineNumbers, 'u', "use line and row number instead of character index when printing annotation");
+    parser.add(config::Profile, '\0', "print time and allocations spent in each parsing stage");
+    parser.add<std::string>(config::Trace, '\0', "save Chrome trace event file of the parsing into file", false);
+    parser.add(config::SchemaReferences, '\0', "refer to named types in generated JSON Schemas via $ref");
+    parser.add<unsigned int>(
+        config::RenderThreads, '\0', "render message bodies and schemas on given number of threads", false, 0);
+    parser.add<unsigned int>(
+        config::ConvertThreads, '\0', "convert resource groups on given number of threads", false, 0);
+    parser.add<unsigned int>(
+        config::SerializeThreads, '\0', "serialize large Parse Result on given number of threads", false, 0);
 
     std::stringstream ss;
 
@@ -88,6 +103,12 @@ void ParseCommadLineOptions(int argc, const char* argv[], /* out */ Config& conf
     conf.format = parser.get<std::string>(config::Format) == "json" ? drafter::JSONFormat : drafter::YAMLFormat;
     conf.output = parser.get<std::string>(config::Output);
     conf.sourceMap = parser.exist(config::Sourcemap);
+    conf.profile = parser.exist(config::Profile);
+    conf.trace = parser.get<std::string>(config::Trace);
+    conf.schemaReferences = parser.exist(config::SchemaReferences);
+    conf.renderThreads = parser.get<unsigned int>(config::RenderThreads);
+    conf.convertThreads = parser.get<unsigned int>(config::ConvertThreads);
+    conf.serializeThreads = parser.get<unsigned int>(config::SerializeThreads);
 
     ValidateParsedCommandLine(parser, conf);
 }
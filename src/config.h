@@ -20,6 +20,12 @@ struct Config {
     drafter::SerializeFormat format;
     bool sourceMap;
     std::string output;
+    bool profile;
+    std::string trace;
+    bool schemaReferences;
+    unsigned int renderThreads;
+    unsigned int convertThreads;
+    unsigned int serializeThreads;
 };
 
 /**
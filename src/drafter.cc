@@ -10,14 +10,14 @@
 #include "snowcrash.h"
 
 #include "refract/Element.h"
-#include "refract/FilterVisitor.h"
-#include "refract/Query.h"
-#include "refract/Iterate.h"
+#include "refract/TypeQueryVisitor.h"
 
 #include "SerializeResult.h"      // FIXME: remove - actualy required by WrapParseResultRefract()
 #include "Serialize.h"            // FIXME: remove - actualy required by WrapperOptions
 #include "ConversionContext.h"    // FIXME: remove - required by ConversionContext
 #include "RefractDataStructure.h" // FIXME: remove - required by SerializeRefract()
+#include "RefractAPI.h"
+#include "DrafterResult.h"
 
 #include "sos.h" // FIXME: remove sos dependency
 #include "sosJSON.h"
@@ -25,6 +25,7 @@
 
 #include "Version.h"
 
+#include <algorithm>
 #include <string.h>
 
 DRAFTER_API drafter_error drafter_parse_blueprint_to(const char* source,
@@ -59,13 +60,51 @@ DRAFTER_API drafter_error drafter_parse_blueprint_to(const char* source,
 
 namespace sc = snowcrash;
 
+namespace
+{
+    /**
+     * \brief Take options given by caller, completed by defaults
+     *
+     * Caller may be built with an older drafter.h, only options within
+     * `size` of the given ones are taken, the rest keeps its default.
+     *
+     * \returns false if options are not given or not initialized
+     */
+    template <typename Options>
+    bool TakeOptions(Options& options, const Options* given)
+    {
+        memset(&options, 0, sizeof(Options));
+
+        if (!given || given->size < sizeof(given->size)) {
+            return false;
+        }
+
+        memcpy(&options, given, std::min(given->size, sizeof(Options)));
+        options.size = sizeof(Options);
+
+        return true;
+    }
+}
+
 /* Parse API Bleuprint and return result, which is a opaque handle for
  * later use*/
 DRAFTER_API drafter_error drafter_parse_blueprint(
     const char* source, drafter_result** out, const drafter_parse_options parse_opts)
 {
+    drafter_parse_options_ex options;
+    drafter_init_parse_options(&options);
 
-    if (!source) {
+    options.requireBlueprintName = parse_opts.requireBlueprintName;
+
+    return drafter_parse_blueprint_ex(source, out, &options);
+}
+
+DRAFTER_API drafter_error drafter_parse_blueprint_ex(
+    const char* source, drafter_result** out, const drafter_parse_options_ex* parse_opts)
+{
+    drafter_parse_options_ex options;
+
+    if (!source || !TakeOptions(options, parse_opts)) {
         return DRAFTER_EINVALID_INPUT;
     }
 
@@ -75,18 +114,38 @@ DRAFTER_API drafter_error drafter_parse_blueprint(
 
     sc::BlueprintParserOptions scOptions = sc::ExportSourcemapOption;
 
-    if (parse_opts.requireBlueprintName) {
+    if (options.requireBlueprintName) {
         scOptions |= sc::RequireBlueprintNameOption;
     }
 
+    std::unique_ptr<sc::Profile> profile;
+
+    if (options.profile || options.trace) {
+        profile.reset(new sc::Profile);
+        profile->trace(options.trace);
+    }
+
+    sc::ProfileSession session(profile.get());
+
     sc::ParseResult<sc::Blueprint> blueprint;
     sc::parse(source, scOptions, blueprint);
 
-    drafter::WrapperOptions wrapperOptions;
+    drafter::WrapperOptions wrapperOptions(false,
+        false,
+        options.schemaReferences,
+        options.lazyRender,
+        options.renderThreads,
+        options.convertThreads);
     drafter::ConversionContext context(wrapperOptions);
-    refract::IElement* result = WrapRefract(blueprint, context);
 
-    *out = result;
+    std::unique_ptr<drafter_result> result(new drafter_result);
+
+    result->element.reset(WrapRefract(blueprint, context));
+    result->profile = std::move(profile);
+    result->pendingAssets = std::move(context.pendingAssets);
+    result->annotations = std::move(context.annotations);
+
+    *out = result.release();
 
     return (drafter_error)blueprint.report.error.code;
 }
@@ -112,19 +171,61 @@ namespace
         *stream << "\n";
         *stream << std::flush;
     }
+
+    /**
+     * \brief Render pending assets of result
+     *
+     * Warnings about assets failing to render are appended to annotations
+     * of the result, as `WrapRefract()` appends warnings of conversion.
+     * Result shared with caller is locked by its mutex.
+     */
+    void RenderResultAssets(drafter_result& res)
+    {
+        if (res.pendingAssets.empty()) {
+            return;
+        }
+
+        sc::Warnings warnings;
+        drafter::RenderPendingAssets(res.pendingAssets, warnings);
+
+        refract::ArrayElement* parseResult = refract::TypeQueryVisitor::as<refract::ArrayElement>(res.element.get());
+
+        if (!parseResult) {
+            return;
+        }
+
+        for (const sc::Warning& warning : warnings) {
+            refract::IElement* annotation = drafter::AnnotationToRefract(warning, drafter::SerializeKey::Warning);
+
+            parseResult->push_back(annotation);
+            res.annotations.push_back(annotation);
+        }
+    }
 }
 
 /* Serialize result to given format*/
 DRAFTER_API char* drafter_serialize(drafter_result* res, const drafter_serialize_options serialize_opts)
+{
+    drafter_serialize_options_ex options;
+    drafter_init_serialize_options(&options);
+
+    options.sourcemap = serialize_opts.sourcemap;
+    options.format = serialize_opts.format;
+
+    return drafter_serialize_ex(res, &options);
+}
+
+DRAFTER_API char* drafter_serialize_ex(drafter_result* res, const drafter_serialize_options_ex* serialize_opts)
 {
 
     drafter::SerializeFormat format = drafter::UnknownFormat;
+    drafter_serialize_options_ex options;
 
-    if (!res) {
+    if (!res || !TakeOptions(options, serialize_opts)) {
         return nullptr;
     }
 
-    switch (serialize_opts.format) {
+    switch (options.format) {
         case DRAFTER_SERIALIZE_JSON:
             format = drafter::JSONFormat;
             break;
@@ -137,10 +238,25 @@ DRAFTER_API char* drafter_serialize(drafter_result* res, const drafter_serialize
             return nullptr;
     }
 
-    drafter::WrapperOptions wrapperOptions(serialize_opts.sourcemap);
+    std::lock_guard<std::mutex> lock(res->mutex);
+    sc::ProfileSession session(res->profile.get());
+
+    // bodies and schemas of lazily rendered result are rendered on first serialization
+    RenderResultAssets(*res);
+
+    sc::ProfileScope scope(sc::SerializeStage);
+
+    drafter::WrapperOptions wrapperOptions(options.sourcemap,
+        false,
+        false,
+        false,
+        0,
+        0,
+        options.threads,
+        options.concurrentSize ? options.concurrentSize : drafter::WrapperOptions::DefaultConcurrentSize);
     drafter::ConversionContext context(wrapperOptions);
 
-    sos::Object result = drafter::SerializeRefract(res, context);
+    sos::Object result = drafter::SerializeRefract(res->element.get(), context);
 
     std::unique_ptr<sos::Serialize> serializer(CreateSerializer(format));
 
@@ -151,11 +267,73 @@ DRAFTER_API char* drafter_serialize(drafter_result* res, const drafter_serialize
     return strdup(out.str().c_str());
 }
 
+namespace
+{
+    /**
+     * \brief Annotations of parse result moved out into a result of their own
+     *
+     * Parse result is freed, returns NULL if it has no annotations.
+     */
+    drafter_result* ExtractAnnotations(drafter_result* result)
+    {
+        drafter_result* out = nullptr;
+
+        refract::ArrayElement* parseResult
+            = refract::TypeQueryVisitor::as<refract::ArrayElement>(result->element.get());
+
+        // assets failing to render are reported as if they were not rendered lazily
+        RenderResultAssets(*result);
+
+        if (parseResult && !result->annotations.empty()) {
+            const drafter::Annotations& annotations = result->annotations;
+            refract::ArrayElement::ValueType elements;
+            refract::ArrayElement::ValueType rest;
+
+            // annotations are moved out of parse result, there is no need to clone them
+            drafter::Annotations::const_iterator annotation = annotations.begin();
+
+            for (refract::IElement* element : parseResult->value) {
+                if (annotation != annotations.end() && element == *annotation) {
+                    elements.push_back(element);
+                    ++annotation;
+                } else {
+                    rest.push_back(element);
+                }
+            }
+
+            parseResult->value.swap(rest);
+
+            refract::ArrayElement* element = new refract::ArrayElement(elements);
+            element->element(drafter::SerializeKey::ParseResult);
+
+            out = new drafter_result;
+            out->element.reset(element);
+            out->profile = std::move(result->profile);
+            out->annotations = std::move(result->annotations);
+        }
+
+        drafter_free_result(result);
+
+        return out;
+    }
+}
+
 /* Parse API Blueprint and return only annotations, if NULL than
  * document is error and warning free.*/
 DRAFTER_API drafter_error drafter_check_blueprint(
     const char* source, drafter_result** res, const drafter_parse_options parse_opts)
 {
+    drafter_parse_options_ex options;
+    drafter_init_parse_options(&options);
+
+    options.requireBlueprintName = parse_opts.requireBlueprintName;
+
+    return drafter_check_blueprint_ex(source, res, &options);
+}
+
+DRAFTER_API drafter_error drafter_check_blueprint_ex(
+    const char* source, drafter_result** res, const drafter_parse_options_ex* parse_opts)
+{
 
     if (!source) {
         return DRAFTER_EINVALID_INPUT;
@@ -163,40 +341,96 @@ DRAFTER_API drafter_error drafter_check_blueprint(
 
     drafter_result* result = nullptr;
 
-    drafter_error ret = drafter_parse_blueprint(source, &result, parse_opts);
+    drafter_error ret = drafter_parse_blueprint_ex(source, &result, parse_opts);
 
     if (!result) {
         return ret;
     }
 
-    drafter_result* out = nullptr;
+    *res = ExtractAnnotations(result);
 
-    refract::FilterVisitor filter(refract::query::Element("annotation"));
-    refract::Iterate<refract::Children> iterate(filter);
-    iterate(*result);
+    return ret;
+}
 
-    if (!filter.empty()) {
-        refract::ArrayElement::ValueType elements;
+DRAFTER_API void drafter_free_result(drafter_result* result)
+{
+    delete result;
+}
 
-        std::transform(filter.elements().begin(),
-            filter.elements().end(),
-            std::back_inserter(elements),
-            std::bind(&refract::IElement::clone, std::placeholders::_1, refract::IElement::cAll));
+DRAFTER_API const drafter_annotation* const* drafter_annotations(const drafter_result* res, size_t* count)
+{
+    if (count) {
+        *count = 0;
+    }
 
-        out = new refract::ArrayElement(elements);
-        out->element(drafter::SerializeKey::ParseResult);
+    if (!res) {
+        return nullptr;
     }
 
-    drafter_free_result(result);
+    // annotations of lazily rendered result are completed before they are returned, so they do
+    // not change afterwards, handle is not const for the first call, it is never created const
+    drafter_result* result = const_cast<drafter_result*>(res);
 
-    *res = out;
+    {
+        std::lock_guard<std::mutex> lock(result->mutex);
+        sc::ProfileSession session(result->profile.get());
 
-    return ret;
+        RenderResultAssets(*result);
+    }
+
+    const size_t size = result->annotations.size();
+
+    if (count) {
+        *count = size;
+    }
+
+    return size ? result->annotations.data() : nullptr;
 }
 
-DRAFTER_API void drafter_free_result(drafter_result* result)
+static_assert(DRAFTER_STAGE_COUNT == static_cast<int>(sc::ProfileStageCount), "drafter_stage mismatch ProfileStage");
+
+DRAFTER_API bool drafter_profile_stage(
+    const drafter_result* res, const drafter_stage stage, drafter_stage_stats* out)
 {
-    delete result;
+    if (!res || !out || stage < 0 || stage >= DRAFTER_STAGE_COUNT) {
+        return false;
+    }
+
+    const sc::Profile* profile = res->profile.get();
+
+    if (!profile) {
+        return false;
+    }
+
+    const sc::StageStatistics& statistics = profile->stage(static_cast<sc::ProfileStage>(stage));
+
+    out->total = statistics.total;
+    out->self = statistics.self;
+    out->calls = statistics.calls;
+    out->allocations = statistics.allocations;
+    out->deallocations = statistics.deallocations;
+    out->bytes = statistics.bytes;
+
+    return true;
+}
+
+DRAFTER_API const char* drafter_stage_name(const drafter_stage stage)
+{
+    return sc::Profile::name(static_cast<sc::ProfileStage>(stage));
+}
+
+DRAFTER_API char* drafter_profile_trace(const drafter_result* res)
+{
+    const sc::Profile* profile = res ? res->profile.get() : NULL;
+
+    if (!profile || !profile->tracing()) {
+        return nullptr;
+    }
+
+    std::ostringstream out;
+    profile->writeTrace(out);
+
+    return strdup(out.str().c_str());
 }
 
 #define VERSION_SHIFT_STEP 8
@@ -49,17 +49,22 @@ extern "C" {
 #endif
 #endif
 
+#include <stddef.h>
+#include <string.h>
+
 #ifndef __cplusplus
 #include <stdbool.h>
-typedef struct drafter_result drafter_result;
+typedef struct drafter_annotation drafter_annotation;
 #else
 namespace refract
 {
     struct IElement;
 }
-typedef refract::IElement drafter_result;
+typedef refract::IElement drafter_annotation;
 #endif
 
+typedef struct drafter_result drafter_result;
+
 /* Serialization formats, currently only YAML or JSON */
 typedef enum { DRAFTER_SERIALIZE_YAML = 0, DRAFTER_SERIALIZE_JSON } drafter_format;
 
@@ -70,6 +75,45 @@ typedef struct {
     bool requireBlueprintName;
 } drafter_parse_options;
 
+/* Extended parsing options, see drafter_parse_blueprint_ex()
+ *
+ * Initialize them by drafter_init_parse_options() before setting any of
+ * them. Options are only ever appended, drafter takes those within `size`
+ * and keeps defaults of the rest, so callers built with an older drafter.h
+ * keep working. All of them default to false or 0.
+ * - size : Size of options the caller is built with, set by drafter_init_parse_options()
+ * - requireBlueprintName : API has to have a name, if not it is a parsing error
+ * - profile : Record per-stage profile of the parse, see drafter_profile_stage(), time of a stage run
+ *   on more threads is the sum of time spent in it by all the threads
+ * - trace : Record trace of the parse (implies profile), see drafter_profile_trace(), spans of
+ *   worker threads are recorded with their own thread id
+ * - schemaReferences : Generated JSON Schemas refer to named types via "$ref" into "definitions"
+ * - lazyRender : Render message bodies and schemas only when the result is serialized, warnings about those
+ *   failing to render are added to annotations of the result by its first drafter_serialize()
+ * - renderThreads : Render message bodies and schemas on given number of threads, 0 or 1 renders them sequentially,
+ *   the number of threads is limited by the number of hardware threads
+ * - convertThreads : Convert resource groups on given number of threads, 0 or 1 converts them sequentially,
+ *   elements of a group are converted apart and traced each within span of the group, the number of
+ *   threads is limited by the number of hardware threads
+ */
+typedef struct {
+    size_t size;
+    bool requireBlueprintName;
+    bool profile;
+    bool trace;
+    bool schemaReferences;
+    bool lazyRender;
+    unsigned renderThreads;
+    unsigned convertThreads;
+} drafter_parse_options_ex;
+
+/* Initialize extended parsing options to their defaults */
+static inline void drafter_init_parse_options(drafter_parse_options_ex* opts)
+{
+    memset(opts, 0, sizeof(*opts));
+    opts->size = sizeof(*opts);
+}
+
 /* Serialization options
  * - sourcemap : Include sourcemap in the serialized result
  * - format : Serialization format see above
@@ -79,6 +123,33 @@ typedef struct {
     drafter_format format;
 } drafter_serialize_options;
 
+/* Extended serialization options, see drafter_serialize_ex()
+ *
+ * Initialize them by drafter_init_serialize_options() before setting any
+ * of them, they are versioned as drafter_parse_options_ex. All of them
+ * default to false or 0.
+ * - size : Size of options the caller is built with, set by drafter_init_serialize_options()
+ * - sourcemap : Include sourcemap in the serialized result
+ * - format : Serialization format see above
+ * - threads : Serialize large results on given number of threads, 0 or 1 serializes them on one thread,
+ *   the number of threads is limited by the number of hardware threads
+ * - concurrentSize : Estimated size (bytes) of results serialized on more threads, 0 for the default 20 MB
+ */
+typedef struct {
+    size_t size;
+    bool sourcemap;
+    drafter_format format;
+    unsigned threads;
+    size_t concurrentSize;
+} drafter_serialize_options_ex;
+
+/* Initialize extended serialization options to their defaults */
+static inline void drafter_init_serialize_options(drafter_serialize_options_ex* opts)
+{
+    memset(opts, 0, sizeof(*opts));
+    opts->size = sizeof(*opts);
+}
+
 typedef enum {
     DRAFTER_OK = 0,
     DRAFTER_EUNKNOWN = -1,
@@ -108,9 +179,19 @@ DRAFTER_API drafter_error drafter_parse_blueprint_to(const char* source,
 DRAFTER_API drafter_error drafter_parse_blueprint(
     const char* source, drafter_result** out, const drafter_parse_options parse_opts);
 
-/* Serialize result to given format, returns NULL if an error is encountered */
+/* Serialize result to given format, returns NULL if an error is encountered
+ *
+ * The first serialization of a lazyRender result completes the result, unless
+ * drafter_annotations() did, calls for one result are serialized by a lock of
+ * the result, so it can be serialized from several threads.
+ */
 DRAFTER_API char* drafter_serialize(drafter_result* res, const drafter_serialize_options serialize_opts);
 
+/* drafter_serialize() with extended options, returns NULL as well if options
+ * are not initialized by drafter_init_serialize_options()
+ */
+DRAFTER_API char* drafter_serialize_ex(drafter_result* res, const drafter_serialize_options_ex* serialize_opts);
+
 /* Free memory allocated for result handler */
 DRAFTER_API void drafter_free_result(drafter_result* res);
 
@@ -123,6 +204,75 @@ DRAFTER_API void drafter_free_result(drafter_result* res);
 DRAFTER_API drafter_error drafter_check_blueprint(
     const char* source, drafter_result** res, const drafter_parse_options parse_opts);
 
+/* drafter_parse_blueprint() with extended options
+ * Returns DRAFTER_EINVALID_INPUT if options are not initialized by drafter_init_parse_options().
+ */
+DRAFTER_API drafter_error drafter_parse_blueprint_ex(
+    const char* source, drafter_result** out, const drafter_parse_options_ex* parse_opts);
+
+/* drafter_check_blueprint() with extended options
+ * Returns DRAFTER_EINVALID_INPUT if options are not initialized by drafter_init_parse_options().
+ */
+DRAFTER_API drafter_error drafter_check_blueprint_ex(
+    const char* source, drafter_result** res, const drafter_parse_options_ex* parse_opts);
+
+/* Annotations (error and warnings) of the result in order of the result,
+ * their number is stored into `count`. Annotations are elements of the result,
+ * they are valid until the result is freed and must not be freed on their own.
+ * Returns NULL if the result has no annotations.
+ *
+ * Annotations of a lazyRender result are completed by the first call, as by
+ * the first drafter_serialize(), so the returned array does not change later.
+ */
+DRAFTER_API const drafter_annotation* const* drafter_annotations(const drafter_result* res, size_t* count);
+
+/* Pipeline stages recorded in the parse profile */
+typedef enum {
+    DRAFTER_STAGE_MARKDOWN = 0,   /* Markdown parsing */
+    DRAFTER_STAGE_BLUEPRINT,      /* Blueprint sections parsing */
+    DRAFTER_STAGE_NAMED_TYPES,    /* Named types registration */
+    DRAFTER_STAGE_REFRACT,        /* Conversion to refract */
+    DRAFTER_STAGE_RENDER_BODY,    /* Message body rendering */
+    DRAFTER_STAGE_RENDER_SCHEMA,  /* Message body schema rendering */
+    DRAFTER_STAGE_EXPAND,         /* MSON expansion */
+    DRAFTER_STAGE_SERIALIZE,      /* Serialization by drafter_serialize() */
+    DRAFTER_STAGE_REPORT,         /* Annotations reporting */
+    DRAFTER_STAGE_COUNT
+} drafter_stage;
+
+/* Statistics of one stage
+ * - total : wall time in seconds including nested stages
+ * - self : wall time in seconds excluding nested stages
+ * - calls : how many times the stage was entered
+ * - allocations, deallocations, bytes : heap operations done by the stage
+ *   itself, zero unless drafter is configured with `--track-allocations`
+ */
+typedef struct {
+    double total;
+    double self;
+    unsigned long calls;
+    unsigned long allocations;
+    unsigned long deallocations;
+    unsigned long long bytes;
+} drafter_stage_stats;
+
+/* Get statistics of given stage for result parsed with profile option.
+ * Serialization of the result is recorded into its profile too.
+ * Returns false if the result has no profile or the stage is unknown.
+ */
+DRAFTER_API bool drafter_profile_stage(
+    const drafter_result* res, const drafter_stage stage, drafter_stage_stats* out);
+
+/* Human readable name of the stage */
+DRAFTER_API const char* drafter_stage_name(const drafter_stage stage);
+
+/* Serialize trace of result parsed with trace option in Chrome trace
+ * event JSON format. Spans of pipeline stages, resource groups, resources,
+ * actions, payloads and named type expansions carry their source map.
+ * Returns NULL if the result has no trace.
+ */
+DRAFTER_API char* drafter_profile_trace(const drafter_result* res);
+
 DRAFTER_API unsigned int drafter_version(void);
 
 DRAFTER_API const char* drafter_version_string(void);
@@ -54,23 +54,33 @@ int ProcessRefract(const Config& config, std::unique_ptr<std::istream>& in, std:
     std::stringstream inputStream;
     inputStream << in->rdbuf();
 
-    drafter_serialize_options options;
+    drafter_serialize_options_ex options;
+    drafter_init_serialize_options(&options);
+
     options.sourcemap = config.sourceMap;
     options.format = config.format == drafter::YAMLFormat ? DRAFTER_SERIALIZE_YAML : DRAFTER_SERIALIZE_JSON;
+    options.threads = config.serializeThreads;
 
-    refract::IElement* result = nullptr;
+    drafter_result* result = nullptr;
 
     // TODO: Read parse options from CLI
-    drafter_parse_options parseOptions = { false };
+    drafter_parse_options_ex parseOptions;
+    drafter_init_parse_options(&parseOptions);
+
+    parseOptions.profile = config.profile;
+    parseOptions.trace = !config.trace.empty();
+    parseOptions.schemaReferences = config.schemaReferences;
+    parseOptions.renderThreads = config.renderThreads;
+    parseOptions.convertThreads = config.convertThreads;
 
-    int ret = drafter_parse_blueprint(inputStream.str().c_str(), &result, parseOptions);
+    int ret = drafter_parse_blueprint_ex(inputStream.str().c_str(), &result, &parseOptions);
 
     if (!result) {
         return -1;
     }
 
     if (!config.validate) { // If not validate, we serialize
-        char* output = drafter_serialize(result, options);
+        char* output = drafter_serialize_ex(result, &options);
 
         if (output) {
             *out << output << "\n" << std::flush;
@@ -81,6 +91,21 @@ int ProcessRefract(const Config& config, std::unique_ptr<std::istream>& in, std:
 
     PrintReport(result, inputStream.str(), config.lineNumbers, ret);
 
+    if (config.profile) {
+        PrintProfile(result);
+    }
+
+    if (!config.trace.empty()) {
+        char* trace = drafter_profile_trace(result);
+
+        if (trace) {
+            std::unique_ptr<std::ostream> traceStream(CreateStreamFromName<std::ostream>(config.trace));
+            *traceStream << trace << std::flush;
+
+            free(trace);
+        }
+    }
+
     drafter_free_result(result);
 
     return ret;
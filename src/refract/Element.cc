@@ -24,27 +24,6 @@ namespace refract
     namespace
     {
 
-        const constexpr std::array<const char*, 13> reservedKeywords = {
-
-            "null",
-            "boolean",
-            "number",
-            "string",
-
-            "member",
-
-            "array",
-            "enum",
-            "object",
-
-            "ref",
-            "select",
-            "option",
-            "extend",
-
-            "generic"
-        };
-
         const constexpr std::array<const char*, 3> noMetaKeywords = { "id", "prefix", "namespace" };
 
         const constexpr std::array<const char*, 0> emptyArray = std::array<const char*, 0>();
@@ -71,7 +50,54 @@ namespace refract
 
     bool isReserved(const std::string& element)
     {
-        return InKeysChecker(reservedKeywords)(element);
+        // Reserved keywords are told apart by their length and first
+        // character, so at most one comparison is made
+        const char* keyword = NULL;
+
+        switch (element.size()) {
+            case 3:
+                keyword = "ref";
+                break;
+
+            case 4:
+                keyword = element[0] == 'n' ? "null" : "enum";
+                break;
+
+            case 5:
+                keyword = "array";
+                break;
+
+            case 6:
+                switch (element[0]) {
+                    case 'n':
+                        keyword = "number";
+                        break;
+                    case 'm':
+                        keyword = "member";
+                        break;
+                    case 'e':
+                        keyword = "extend";
+                        break;
+                    case 's':
+                        keyword = element[1] == 't' ? "string" : "select";
+                        break;
+                    case 'o':
+                        keyword = element[1] == 'b' ? "object" : "option";
+                        break;
+                    default:
+                        return false;
+                }
+                break;
+
+            case 7:
+                keyword = element[0] == 'b' ? "boolean" : "generic";
+                break;
+
+            default:
+                return false;
+        }
+
+        return !memcmp(element.data(), keyword, element.size());
     }
 
     IElement::MemberElementCollection::const_iterator IElement::MemberElementCollection::find(
@@ -19,6 +19,7 @@
 #include "Visitor.h"
 
 #include "ElementFwd.h"
+#include "Symbol.h"
 
 namespace refract
 {
@@ -144,9 +145,15 @@ namespace refract
          * usualy injected by "trait", but you can set own
          * via pair method `element(std::string)`
          */
-        virtual std::string element() const = 0;
+        virtual const std::string& element() const = 0;
         virtual void element(const std::string&) = 0;
 
+        /**
+         * return interned "name" of element
+         * cheap to compare and hash, \see Symbol
+         */
+        virtual const Symbol& symbol() const = 0;
+
         // NOTE: probably rename to Accept
         virtual void content(Visitor& v) const = 0;
 
@@ -189,8 +196,16 @@ namespace refract
         virtual ~IElement() {}
     };
 
+    /**
+     * True if element is one of the base (reserved) elements
+     */
     bool isReserved(const std::string& element);
 
+    inline bool isReserved(const Symbol& element)
+    {
+        return element.reserved();
+    }
+
     /**
      * CRTP implementation of RefractElement
      */
@@ -204,21 +219,37 @@ namespace refract
         typedef typename TraitType::ValueType ValueType;
 
     protected:
-        std::string element_;
+        Symbol element_;
         bool hasContent; ///< was content of element already set? \see empty()
 
+        static const Symbol& traitSymbol()
+        {
+            // outlives any parse, so it is not interned into one
+            static const Symbol symbol = []() {
+                SymbolScope global(NULL);
+                return Symbol(TraitType::element());
+            }();
+
+            return symbol;
+        }
+
     public:
         // FIXME: move into protected part, currently still required in ComparableVisitor
         ValueType value;
 
-        virtual std::string element() const
+        virtual const std::string& element() const
         {
-            return element_.empty() ? TraitType::element() : element_;
+            return symbol().str();
         }
 
         virtual void element(const std::string& name)
         {
-            element_ = name;
+            element_ = Symbol(name);
+        }
+
+        virtual const Symbol& symbol() const
+        {
+            return element_.empty() ? traitSymbol() : element_;
         }
 
         void set(const ValueType& val)
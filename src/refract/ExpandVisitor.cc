@@ -15,6 +15,7 @@
 #include <sstream>
 
 #include "SourceAnnotation.h"
+#include "Profile.h"
 
 #include "IsExpandableVisitor.h"
 #include "ExpandVisitor.h"
@@ -168,14 +169,28 @@ namespace refract
             return o;
         }
 
-        std::deque<std::string> members;
+        // names of named types being expanded, compared by value
+        // as referenced names are not interned
+        std::deque<const std::string*> members;
+
+        bool IsExpanding(const std::string& name) const
+        {
+            for (const std::string* member : members) {
+                if (*member == name) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
 
         template <typename T>
         IElement* ExpandNamedType(const T& e)
         {
+            const std::string& name = e.element();
 
             // Look for Circular Reference thro members
-            if (std::find(members.begin(), members.end(), e.element()) != members.end()) {
+            if (IsExpanding(name)) {
                 // To avoid unfinised recursion just clone
                 const IElement* root = FindRootAncestor(e.element(), registry);
                 // FIXME: if not found root
@@ -184,7 +199,9 @@ namespace refract
                 return result;
             }
 
-            members.push_back(e.element());
+            snowcrash::TraceScope trace("expand", e.element(), mdp::BytesRangeSet());
+
+            members.push_back(&name);
 
             ExtendElement* tree = GetInheritanceTree(e.element(), registry);
             ExtendElement* extend = ExpandMembers(*tree);
@@ -210,7 +227,7 @@ namespace refract
                 return ref;
             }
 
-            if (std::find(members.begin(), members.end(), ref->value) != members.end()) {
+            if (IsExpanding(ref->value)) {
 
                 std::stringstream msg;
                 msg << "named type '";
@@ -220,7 +237,7 @@ namespace refract
                 throw snowcrash::Error(msg.str(), snowcrash::MSONError);
             }
 
-            members.push_back(ref->value);
+            members.push_back(&ref->value);
 
             if (IElement* referenced = registry.find(ref->value)) {
                 referenced = ExpandOrClone(referenced);
@@ -241,7 +258,7 @@ namespace refract
         ExpandElement(const T& e, ExpandVisitor::Context* context) : result(NULL)
         {
 
-            if (!isReserved(e.element())) { // expand named type
+            if (!isReserved(e.symbol())) { // expand named type
                 result = context->ExpandNamedType(e);
             }
         }
@@ -307,9 +324,7 @@ namespace refract
                 return;
             }
 
-            std::string en = e.element();
-
-            if (!isReserved(en)) { // expand named type
+            if (!isReserved(e.symbol())) { // expand named type
                 result = context->ExpandNamedType(e);
             } else { // walk throught members and expand them
                 result = context->ExpandMembers(e);
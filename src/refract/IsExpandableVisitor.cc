@@ -16,13 +16,7 @@ namespace refract
         struct CheckElement {
             bool checkElement(const IElement* e) const
             {
-                std::string type;
-
-                if (e) {
-                    type = e->element();
-                }
-
-                return !isReserved(type);
+                return !e || !isReserved(e->symbol());
             }
         };
 
@@ -10,9 +10,36 @@
 
 #include "ElementFwd.h"
 
+#include <vector>
+
 namespace refract
 {
 
+    /**
+     * Element waiting to be iterated and its depth under iterated root
+     */
+    struct IteratedElement {
+        const IElement* element;
+        int level;
+    };
+
+    /**
+     * Elements waiting to be iterated, the last one is iterated first
+     */
+    typedef std::vector<IteratedElement> IterateStack;
+
+    /**
+     * Push `elements` to `stack` so they are iterated in order of `elements`
+     */
+    inline void PushIterated(IterateStack& stack, int level, const RefractElements& elements)
+    {
+        for (RefractElements::const_reverse_iterator i = elements.rbegin(); i != elements.rend(); ++i) {
+            if (!(*i))
+                continue;
+            stack.push_back({ *i, level });
+        }
+    }
+
     struct Recursive {
 
         template <typename T, typename V = typename T::ValueType>
@@ -20,46 +47,43 @@ namespace refract
 
             template <typename U, bool dummy = true>
             struct Impl {
-                void operator()(IApply* apply, Visitor&, const U&) {}
+                void operator()(IterateStack&, int, const U&) {}
             };
 
             template <bool dummy>
             struct Impl<RefractElements, dummy> {
-                void operator()(IApply* apply, Visitor& v, const RefractElements& e)
+                void operator()(IterateStack& stack, int level, const RefractElements& e)
                 {
-                    for (RefractElements::const_iterator i = e.begin(); i != e.end(); ++i) {
-                        if (!(*i))
-                            continue;
-                        (*i)->content(v);
-                    }
+                    PushIterated(stack, level, e);
                 }
             };
 
             template <bool dummy>
             struct Impl<MemberElement::ValueType, dummy> {
-                void operator()(IApply* apply, Visitor& v, const MemberElement::ValueType& e)
+                void operator()(IterateStack& stack, int level, const MemberElement::ValueType& e)
                 {
-                    if (e.first) {
-                        e.first->content(v);
+                    // key is iterated before value
+                    if (e.second) {
+                        stack.push_back({ e.second, level });
                     }
 
-                    if (e.second) {
-                        e.second->content(v);
+                    if (e.first) {
+                        stack.push_back({ e.first, level });
                     }
                 }
             };
 
-            void operator()(IApply* apply, Visitor& iterable, const T& e)
+            void operator()(IApply* apply, IterateStack& stack, int level, const T& e)
             {
                 apply->visit(e);
-                Impl<V>()(apply, iterable, e.value);
+                Impl<V>()(stack, level + 1, e.value);
             }
         };
 
         template <typename T>
-        void operator()(IApply* apply, Visitor& iterable, const T& e)
+        void operator()(IApply* apply, IterateStack& stack, int level, const T& e)
         {
-            Iterate<T>()(apply, iterable, e);
+            Iterate<T>()(apply, stack, level, e);
         }
     };
 
@@ -70,46 +94,41 @@ namespace refract
 
             template <typename U, bool dummy = true>
             struct Impl {
-                void operator()(Children* strategy, IApply* apply, Visitor&, const U&) {}
+                void operator()(IterateStack&, const U&) {}
             };
 
             template <bool dummy>
             struct Impl<RefractElements, dummy> {
-                void operator()(Children* strategy, IApply* apply, Visitor& v, const RefractElements& e)
+                void operator()(IterateStack& stack, const RefractElements& e)
                 {
-                    if (strategy->level) { // we need no go deeply
-                        return;
-                    }
-
-                    strategy->level++;
-                    for (RefractElements::const_iterator i = e.begin(); i != e.end(); ++i) {
-                        if (!(*i))
-                            continue;
-                        (*i)->content(v);
-                    }
-                    strategy->level--;
+                    PushIterated(stack, 1, e);
                 }
             };
 
-            void operator()(Children* strategy, IApply* apply, Visitor& iterable, const T& e)
+            void operator()(IApply* apply, IterateStack& stack, int level, const T& e)
             {
-                Impl<V>()(strategy, apply, iterable, e.value);
+                if (level == 1) {
+                    apply->visit(e);
+                    return; // we need no go deeply
+                }
+
+                Impl<V>()(stack, e.value);
             }
         };
 
-        int level;
-        Children() : level(0) {}
-
         template <typename T>
-        void operator()(IApply* apply, Visitor& iterable, const T& e)
+        void operator()(IApply* apply, IterateStack& stack, int level, const T& e)
         {
-            if (level == 1) {
-                apply->visit(e);
-            }
-            Iterate<T>()(this, apply, iterable, e);
+            Iterate<T>()(apply, stack, level, e);
         }
     };
 
+    /**
+     * Visit elements of tree in document order
+     *
+     * Elements are iterated from an explicit stack, not by recursion, so
+     * the depth of iterated tree is not limited by size of call stack.
+     */
     template <typename Strategy = Recursive>
     class Iterate
     {
@@ -117,13 +136,13 @@ namespace refract
         struct Impl {
 
             Strategy* strategy;
-            Visitor* iterator;
             IApply* apply;
+            IterateStack* stack;
+            int level;
 
             void operator()(const IElement& e)
             {
-                // redirect to concrete override
-                e.content(*iterator);
+                // elements are dispatched to concrete override by content()
             }
 
             template <typename T>
@@ -133,7 +152,7 @@ namespace refract
                     return;
                     // apply->visit(e);
                 }
-                (*strategy)(apply, *iterator, e);
+                (*strategy)(apply, *stack, level, e);
             }
         };
 
@@ -141,14 +160,15 @@ namespace refract
         Visitor iterator;
         Strategy strategy;
         IApply* apply;
+        IterateStack stack;
 
     public:
         template <typename Functor>
         explicit Iterate(Functor& functor) : impl(), iterator(impl), strategy(), apply(new ApplyImpl<Functor>(functor))
         {
             impl.strategy = &strategy;
-            impl.iterator = &iterator;
             impl.apply = apply;
+            impl.stack = &stack;
         }
 
         ~Iterate()
@@ -160,7 +180,17 @@ namespace refract
 
         void operator()(const IElement& e)
         {
-            iterator.visit(e);
+            stack.clear();
+            stack.push_back({ &e, 0 });
+
+            while (!stack.empty()) {
+                IteratedElement next = stack.back();
+                stack.pop_back();
+
+                impl.level = next.level;
+                // redirect to concrete override
+                next.element->content(iterator);
+            }
         }
     };
 
@@ -0,0 +1,51 @@
+//
+//  refract/JSONSchemaCache.cc
+//  librefract
+//
+
+#include "JSONSchemaCache.h"
+
+namespace refract
+{
+
+    namespace
+    {
+        std::string FragmentKey(const std::string& name, bool fixed, bool fixedType)
+        {
+            // flags are appended as single character, so keys of distinct names can not collide
+            std::string key = name;
+            key.push_back('0' + (fixed ? 1 : 0) + (fixedType ? 2 : 0));
+            return key;
+        }
+    }
+
+    JSONSchemaCache::JSONSchemaCache(bool references) : useReferences(references) {}
+
+    bool JSONSchemaCache::references() const
+    {
+        return useReferences;
+    }
+
+    const JSONSchemaCache::Fragment* JSONSchemaCache::find(const std::string& name, bool fixed, bool fixedType) const
+    {
+        Fragments::const_iterator i = fragments.find(FragmentKey(name, fixed, fixedType));
+
+        if (i == fragments.end()) {
+            return NULL;
+        }
+
+        return &i->second;
+    }
+
+    const JSONSchemaCache::Fragment& JSONSchemaCache::add(
+        const std::string& name, bool fixed, bool fixedType, Fragment&& fragment)
+    {
+        return fragments[FragmentKey(name, fixed, fixedType)] = std::move(fragment);
+    }
+
+    void JSONSchemaCache::clear()
+    {
+        fragments.clear();
+    }
+
+}; // namespace refract
@@ -0,0 +1,67 @@
+//
+//  refract/JSONSchemaCache.h
+//  librefract
+//
+#ifndef REFRACT_JSONSCHEMACACHE_H
+#define REFRACT_JSONSCHEMACACHE_H
+
+#include <unordered_map>
+#include <string>
+
+#include "JSONValue.h"
+
+namespace refract
+{
+
+    /**
+     * JSON Schema fragments of named types
+     *
+     * Shared by all schemas rendered for one document, a named type
+     * is rendered once for each combination of inherited `fixed` and
+     * `fixedType` flags and the fragment is reused by every schema
+     * using the type.
+     *
+     * With `references` enabled, schemas refer to named types by
+     * `$ref` into `definitions` instead of inlining them.
+     */
+    class JSONSchemaCache
+    {
+    public:
+        struct Fragment {
+            /** Members of schema of named type */
+            JSONValue::Members schema;
+
+            /** Definitions added while rendering the named type */
+            JSONValue::Members definitions;
+
+            /** `fixed` and `fixedType` state after rendering */
+            bool fixed;
+            bool fixedType;
+
+            Fragment() : fixed(false), fixedType(false) {}
+        };
+
+    private:
+        typedef std::unordered_map<std::string, Fragment> Fragments;
+        Fragments fragments;
+        bool useReferences;
+
+        JSONSchemaCache(const JSONSchemaCache&);
+        JSONSchemaCache& operator=(const JSONSchemaCache&);
+
+    public:
+        explicit JSONSchemaCache(bool references = false);
+
+        bool references() const;
+
+        /** Fragment of named type, NULL if it is not rendered yet */
+        const Fragment* find(const std::string& name, bool fixed, bool fixedType) const;
+
+        const Fragment& add(const std::string& name, bool fixed, bool fixedType, Fragment&& fragment);
+
+        void clear();
+    };
+
+}; // namespace refract
+
+#endif // #ifndef REFRACT_JSONSCHEMACACHE_H
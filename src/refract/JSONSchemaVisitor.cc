@@ -8,34 +8,200 @@
 //
 
 #include "VisitorUtils.h"
-#include "sosJSON.h"
-#include <sstream>
-#include <iostream>
+#include <algorithm>
+#include <iterator>
 #include <map>
 #include <set>
+#include <memory>
 
 #include "RenderJSONVisitor.h"
 #include "JSONSchemaVisitor.h"
 #include "SerializeCompactVisitor.h"
+#include "JSONWriter.h"
 
 #include <assert.h>
 
 namespace refract
 {
 
-    template <typename T>
-    void CloneMembers(T* a, const RefractElements* val)
+    namespace
     {
-        for (const auto& value : *val) {
 
-            if ((value)->empty()) {
-                continue;
+        JSONValue CompactValue(const IElement& e)
+        {
+            SerializeCompactVisitor<JSONValue> v;
+            VisitBy(e, v);
+            return std::move(v.value());
+        }
+
+        JSONValue PrimitiveValue(const std::string& value)
+        {
+            return JSONValue::String(value);
+        }
+
+        JSONValue PrimitiveValue(double value)
+        {
+            return JSONValue::Number(value);
+        }
+
+        JSONValue PrimitiveValue(bool value)
+        {
+            return JSONValue::Boolean(value);
+        }
+
+        /**
+         * Looks for named type expanded into an element without members,
+         * `ExpandVisitor` does so to stop circular expansion. Expansion
+         * of named type without it does not depend on where it is used.
+         */
+        class CircularReferenceQuery
+        {
+            bool found_;
+
+            void check(const IElement* e)
+            {
+                if (!e || found_) {
+                    return;
+                }
+
+                if (e->meta.find("ref") != e->meta.end()) {
+                    found_ = true;
+                    return;
+                }
+
+                VisitBy(*e, *this);
             }
 
-            RenderJSONVisitor v;
-            Visit(v, *value);
-            IElement* e = v.getOwnership();
-            a->push_back(e);
+            template <typename Values>
+            void checkValues(const Values& values)
+            {
+                for (auto const& value : values) {
+                    check(value);
+                }
+            }
+
+        public:
+            CircularReferenceQuery() : found_(false) {}
+
+            void operator()(const IElement& e) {}
+            void operator()(const HolderElement& e) {}
+            void operator()(const NullElement& e) {}
+            void operator()(const StringElement& e) {}
+            void operator()(const NumberElement& e) {}
+            void operator()(const BooleanElement& e) {}
+
+            void operator()(const EnumElement& e)
+            {
+                check(e.value);
+            }
+
+            void operator()(const ArrayElement& e)
+            {
+                checkValues(e.value);
+            }
+
+            void operator()(const MemberElement& e)
+            {
+                check(e.value.first);
+                check(e.value.second);
+            }
+
+            void operator()(const ObjectElement& e)
+            {
+                checkValues(e.value);
+            }
+
+            void operator()(const RefElement& e)
+            {
+                // resolved mixin carries `ref` in meta, look into its members only
+                auto resolved = e.attributes.find("resolved");
+
+                if (resolved != e.attributes.end() && (*resolved)->value.second) {
+                    VisitBy(*(*resolved)->value.second, *this);
+                }
+            }
+
+            void operator()(const ExtendElement& e)
+            {
+                // inherited types carry `ref` in meta, look into their members only
+                for (auto const& value : e.value) {
+                    if (value && !found_) {
+                        VisitBy(*value, *this);
+                    }
+                }
+            }
+
+            void operator()(const OptionElement& e)
+            {
+                checkValues(e.value);
+            }
+
+            void operator()(const SelectElement& e)
+            {
+                checkValues(e.value);
+            }
+
+            bool found() const
+            {
+                return found_;
+            }
+        };
+
+        bool HasCircularReference(const ExtendElement& e)
+        {
+            CircularReferenceQuery query;
+            query(e);
+            return query.found();
+        }
+
+        /**
+         * Name of named type expanded into `e` by `ExpandVisitor`, found
+         * only if the type is used as it is, without any amendments
+         */
+        bool NamedTypeUsage(const ExtendElement& e, std::string& name)
+        {
+            if (e.value.size() < 2) {
+                return false;
+            }
+
+            const IElement* type = e.value[e.value.size() - 2];
+            const IElement* usage = e.value.back();
+
+            if (!type || !usage || !usage->empty() || !usage->attributes.empty() || !usage->meta.empty()) {
+                return false;
+            }
+
+            auto ref = type->meta.find("ref");
+
+            if (ref == type->meta.end()) {
+                return false;
+            }
+
+            const StringElement* str = TypeQueryVisitor::as<StringElement>((*ref)->value.second);
+
+            if (!str || str->value.empty()) {
+                return false;
+            }
+
+            name = str->value;
+            return true;
+        }
+
+        void CloneMembers(JSONValue::Items& a, const RefractElements* val)
+        {
+            for (const auto& value : *val) {
+
+                if ((value)->empty()) {
+                    continue;
+                }
+
+                RenderJSONVisitor v;
+                Visit(v, *value);
+
+                if (!v.empty()) {
+                    a.push_back(JSONValue::Raw(v.getString()));
+                }
+            }
         }
     }
 
@@ -63,21 +229,19 @@ namespace refract
         }
     }
 
-    JSONSchemaVisitor::JSONSchemaVisitor(
-        ObjectElement* pDefinitions /*= nullptr*/, bool _fixed /*= false*/, bool _fixedType /*= false*/)
-        : pDefs(pDefinitions), fixed(_fixed), fixedType(_fixedType)
+    JSONSchemaVisitor::JSONSchemaVisitor(JSONValue* pDefinitions /*= nullptr*/,
+        bool _fixed /*= false*/,
+        bool _fixedType /*= false*/,
+        JSONSchemaCache* _cache /*= nullptr*/)
+        : obj(JSONValue::ObjectType),
+          defs(JSONValue::ObjectType),
+          pDefs(pDefinitions),
+          fixed(_fixed),
+          fixedType(_fixedType),
+          cache(_cache)
     {
-        pObj = new ObjectElement;
-
         if (!pDefs) {
-            pDefs = new ObjectElement;
-        }
-    }
-
-    JSONSchemaVisitor::~JSONSchemaVisitor()
-    {
-        if (nullptr != pObj) {
-            delete pObj;
+            pDefs = &defs;
         }
     }
 
@@ -111,7 +275,7 @@ namespace refract
 
     void JSONSchemaVisitor::setSchemaType(const std::string& type)
     {
-        addMember("type", new StringElement(type));
+        addMember("type", JSONValue::String(type));
     }
 
     void JSONSchemaVisitor::addSchemaType(const std::string& type)
@@ -119,14 +283,13 @@ namespace refract
         // FIXME: this will not work corretly if "type" attribute will already
         // have more members. Need to check if type is it is Array and for
         // already pushed types
-        MemberElement* m = FindMemberByKey(*pObj, "type");
-
-        if (m && m->value.second) {
-            IElement* t = m->value.second;
-            ArrayElement* a = new ArrayElement;
-            a->push_back(t);
-            a->push_back(IElement::Create(type));
-            m->value.second = a;
+        JSONValue* m = obj.find("type");
+
+        if (m) {
+            JSONValue a = JSONValue::Array();
+            a.push(std::move(*m));
+            a.push(JSONValue::String(type));
+            *m = std::move(a);
         } else {
             setSchemaType(type);
         }
@@ -134,17 +297,65 @@ namespace refract
 
     void JSONSchemaVisitor::addNullToEnum()
     {
-        MemberElement* m = FindMemberByKey(*pObj, "enum");
+        JSONValue* m = obj.find("enum");
 
-        if (m && m->value.second) {
-            ArrayElement* a = TypeQueryVisitor::as<ArrayElement>(m->value.second);
-            a->push_back(new NullElement);
+        if (m && m->type == JSONValue::ArrayType) {
+            m->push(JSONValue::Null());
         }
     }
 
-    void JSONSchemaVisitor::addMember(const std::string& key, IElement* val)
+    void JSONSchemaVisitor::addMember(const std::string& key, JSONValue&& val)
+    {
+        obj.add(key, std::move(val));
+    }
+
+    void JSONSchemaVisitor::addDefinitions(const JSONValue::Members& definitions)
     {
-        pObj->push_back(new MemberElement(key, val));
+        for (auto const& definition : definitions) {
+            pDefs->set(definition.first, JSONValue(definition.second));
+        }
+    }
+
+    void JSONSchemaVisitor::resolveReference()
+    {
+        if (reference.empty()) {
+            return;
+        }
+
+        JSONValue ref = JSONValue::Object();
+        ref.add("$ref", JSONValue::String("#/definitions/" + reference));
+        reference.clear();
+
+        if (obj.members.empty()) {
+            obj = std::move(ref);
+            return;
+        }
+
+        // keywords next to `$ref` are ignored, combine the reference with them to keep them in effect
+        JSONValue::Members keywords = std::move(obj.members);
+        obj = JSONValue::Object();
+
+        JSONValue a = JSONValue::Array();
+        a.push(std::move(ref));
+
+        auto type = std::find_if(keywords.begin(), keywords.end(), [](const JSONValue::Members::value_type& keyword) {
+            return keyword.first == "type";
+        });
+
+        if (type != keywords.end()) {
+            // type added to named type (e.g. nullable) is an alternative to it
+            JSONValue alternative = JSONValue::Object();
+            alternative.add("type", std::move(type->second));
+            keywords.erase(type);
+
+            a.push(std::move(alternative));
+            obj.add("anyOf", std::move(a));
+        } else {
+            obj.add("allOf", std::move(a));
+        }
+
+        obj.members.insert(
+            obj.members.end(), std::make_move_iterator(keywords.begin()), std::make_move_iterator(keywords.end()));
     }
 
     bool JSONSchemaVisitor::allItemsEmpty(const ArrayElement::ValueType* val)
@@ -161,9 +372,9 @@ namespace refract
             setPrimitiveType(e);
 
             if (fixed) {
-                ArrayElement* a = new ArrayElement;
-                a->push_back(IElement::Create(*value));
-                addMember("enum", a);
+                JSONValue a = JSONValue::Array();
+                a.push(PrimitiveValue(*value));
+                addMember("enum", std::move(a));
             }
         }
     }
@@ -175,7 +386,7 @@ namespace refract
 
     void JSONSchemaVisitor::operator()(const MemberElement& e)
     {
-        JSONSchemaVisitor renderer(pDefs);
+        JSONSchemaVisitor renderer(pDefs, false, false, cache);
 
         if (e.value.second) {
             if (IsTypeAttribute(e, "fixed") || fixed) {
@@ -202,8 +413,7 @@ namespace refract
             IElement* desc = GetDescription(e);
 
             if (desc) {
-                IElement* d = desc->clone();
-                renderer.addMember("description", d);
+                renderer.addMember("description", CompactValue(*desc));
             }
 
             if (IsTypeAttribute(e, "nullable")) {
@@ -220,7 +430,7 @@ namespace refract
                 auto defaultIt = e.value.second->attributes.find("default");
 
                 if (defaultIt != e.value.second->attributes.end()) {
-                    renderer.addMember("default", (*defaultIt)->clone());
+                    renderer.addMember("default", CompactValue(**defaultIt));
                 }
             }
 
@@ -234,21 +444,23 @@ namespace refract
         }
     }
 
-    ObjectElement* JSONSchemaVisitor::definitionFromVariableProperty(JSONSchemaVisitor& renderer)
+    JSONValue JSONSchemaVisitor::definitionFromVariableProperty(JSONSchemaVisitor& renderer)
     {
-        ObjectElement* definition = new ObjectElement();
+        JSONValue definition = JSONValue::Object();
 
-        definition->push_back(new MemberElement("type", new StringElement("object")));
+        definition.add("type", JSONValue::String("object"));
 
-        definition->push_back(
-            new MemberElement("patternProperties", new ObjectElement(new MemberElement("", renderer.getOwnership()))));
+        JSONValue patternProperties = JSONValue::Object();
+        patternProperties.add("", renderer.getOwnership());
+
+        definition.add("patternProperties", std::move(patternProperties));
 
         return definition;
     }
 
-    ArrayElement* JSONSchemaVisitor::arrayFromProps(std::vector<MemberElement*>& props)
+    JSONValue JSONSchemaVisitor::arrayFromProps(std::vector<MemberElement*>& props)
     {
-        ArrayElement* a = new ArrayElement;
+        JSONValue a = JSONValue::Array();
 
         for (auto const& prop : props) {
 
@@ -256,41 +468,44 @@ namespace refract
 
             if (str) {
                 bool fixedType = IsTypeAttribute(*prop, "fixedType");
-                JSONSchemaVisitor renderer(pDefs, fixed, fixedType);
+                JSONSchemaVisitor renderer(pDefs, fixed, fixedType, cache);
                 Visit(renderer, *prop->value.second);
 
-                pDefs->push_back(new MemberElement(str->value, definitionFromVariableProperty(renderer)));
+                pDefs->set(str->value, definitionFromVariableProperty(renderer));
 
-                a->push_back(
-                    new ObjectElement(new MemberElement("$ref", new StringElement("#/definitions/" + str->value))));
+                JSONValue ref = JSONValue::Object();
+                ref.add("$ref", JSONValue::String("#/definitions/" + str->value));
+                a.push(std::move(ref));
             }
         }
 
         return a;
     }
 
-    void JSONSchemaVisitor::addVariableProps(std::vector<MemberElement*>& props, ObjectElement* o)
+    void JSONSchemaVisitor::addVariableProps(std::vector<MemberElement*>& props, JSONValue& o)
     {
-        if (o->empty() && props.size() == 1) {
+        if (o.members.empty() && props.size() == 1) {
             StringElement* str = TypeQueryVisitor::as<StringElement>(props[0]->value.first);
 
             if (str) {
                 bool fixedType = IsTypeAttribute(*props.front(), "fixedType");
-                JSONSchemaVisitor renderer(pDefs, fixed, fixedType);
+                JSONSchemaVisitor renderer(pDefs, fixed, fixedType, cache);
                 Visit(renderer, *props.front()->value.second);
 
-                pDefs->push_back(new MemberElement(str->value, definitionFromVariableProperty(renderer)));
+                pDefs->set(str->value, definitionFromVariableProperty(renderer));
 
-                addMember("$ref", new StringElement("#/definitions/" + str->value));
+                addMember("$ref", JSONValue::String("#/definitions/" + str->value));
             }
         } else {
-            ArrayElement* a = arrayFromProps(props);
+            JSONValue a = arrayFromProps(props);
 
-            if (!o->empty()) {
-                a->push_back(new ObjectElement(new MemberElement("properties", o)));
+            if (!o.members.empty()) {
+                JSONValue properties = JSONValue::Object();
+                properties.add("properties", std::move(o));
+                a.push(std::move(properties));
             }
 
-            addMember("allOf", a);
+            addMember("allOf", std::move(a));
         }
     }
 
@@ -299,10 +514,10 @@ namespace refract
         ObjectElement::ValueType val;
         IncludeMembers(e, val);
 
-        ObjectElement* o = new ObjectElement;
-        ArrayElement::ValueType reqVals;
+        JSONValue o = JSONValue::Object();
+        JSONValue::Items reqVals;
         std::vector<MemberElement*> varProps;
-        RefractElements oneOfMembers;
+        JSONValue::Items oneOfMembers;
 
         if (IsTypeAttribute(e, "fixed")) {
             fixed = true;
@@ -316,56 +531,51 @@ namespace refract
 
         if (!varProps.empty()) {
             addVariableProps(varProps, o);
-            if (o->value.empty()) {
-                delete o;
-            }
         } else {
             setSchemaType("object");
-            addMember("properties", o);
+            addMember("properties", std::move(o));
         }
 
         if (!reqVals.empty()) {
-            addMember("required", new ArrayElement(reqVals));
+            addMember("required", JSONValue::Array(std::move(reqVals)));
         }
 
         if (!oneOfMembers.empty()) {
-            addMember("oneOf", new ArrayElement(oneOfMembers));
+            addMember("oneOf", JSONValue::Array(std::move(oneOfMembers)));
         }
 
         if (fixed || fixedType) {
-            addMember("additionalProperties", IElement::Create(false));
+            addMember("additionalProperties", JSONValue::Boolean(false));
         }
     }
 
     void JSONSchemaVisitor::anyOf(
         std::map<std::string, std::vector<IElement*> >& types, std::vector<std::string>& typesOrder)
     {
-        ArrayElement* a = new ArrayElement;
+        JSONValue a = JSONValue::Array();
 
         for (auto const& item : typesOrder) {
 
             const std::vector<IElement*>& items = types[item];
 
             IElement* elm = items.front();
-            JSONSchemaVisitor v(pDefs);
+            JSONSchemaVisitor v(pDefs, false, false, cache);
             Visit(v, *elm);
 
             if (TypeQueryVisitor::as<EnumElement>(elm)) {
-                v.addMember("enum", elm->clone());
+                v.addMember("enum", CompactValue(*elm));
             } else if (!TypeQueryVisitor::as<ObjectElement>(elm)) {
-                ArrayElement::ValueType enmVals;
-                CloneMembers(&enmVals, &items);
+                JSONValue::Items enmVals;
+                CloneMembers(enmVals, &items);
 
                 if (!enmVals.empty()) {
-                    ArrayElement* enm = new ArrayElement;
-                    enm->set(enmVals);
-                    v.addMember("enum", enm);
+                    v.addMember("enum", JSONValue::Array(std::move(enmVals)));
                 }
             }
 
-            a->push_back(v.getOwnership());
+            a.push(v.getOwnership());
         }
-        addMember("anyOf", a);
+        addMember("anyOf", std::move(a));
     }
 
     void JSONSchemaVisitor::operator()(const ArrayElement& e)
@@ -376,7 +586,6 @@ namespace refract
             return;
         }
 
-        JSONSchemaVisitor renderer(pDefs);
         setSchemaType("array");
 
         if (IsTypeAttribute(e, "fixed")) {
@@ -388,7 +597,7 @@ namespace refract
         }
 
         if (fixed || fixedType) {
-            ArrayElement::ValueType av;
+            JSONValue::Items av;
             bool allEmpty = allItemsEmpty(val);
 
             for (auto const& value : *val) {
@@ -402,7 +611,7 @@ namespace refract
                 // want them in the schema, otherwise skip
                 // empty ones
                 if (allEmpty || !value->empty()) {
-                    JSONSchemaVisitor v(pDefs, fixed);
+                    JSONSchemaVisitor v(pDefs, fixed, false, cache);
                     Visit(v, *value);
                     av.push_back(v.getOwnership());
                 }
@@ -410,12 +619,10 @@ namespace refract
 
             if (!av.empty()) {
                 if (av.size() == 1) {
-                    addMember("items", av[0]);
+                    addMember("items", std::move(av[0]));
 
                 } else {
-                    ArrayElement* a = new ArrayElement;
-                    a->set(av);
-                    addMember("items", a);
+                    addMember("items", JSONValue::Array(std::move(av)));
                 }
             }
         }
@@ -423,8 +630,7 @@ namespace refract
         const ArrayElement* def = GetDefault(e);
 
         if (def && !def->empty()) {
-            ArrayElement* d = static_cast<ArrayElement*>(def->clone());
-            addMember("default", d);
+            addMember("default", CompactValue(*def));
         }
     }
 
@@ -469,10 +675,10 @@ namespace refract
         } else {
             const EnumElement* def = GetDefault(e);
             if (!elms.empty() || (def && !def->empty())) {
-                ArrayElement* a = new ArrayElement;
+                JSONValue::Items a;
                 CloneMembers(a, &elms);
                 setSchemaType(types.begin()->first);
-                addMember("enum", a);
+                addMember("enum", JSONValue::Array(std::move(a)));
             }
         }
 
@@ -481,14 +687,13 @@ namespace refract
         // this works because "default" is everytime set by value
         // if value will be moved into "enumerations" it need aditional check
         if (def && !def->empty() && !def->value->empty()) {
-            IElement* d = def->value->clone();
-            addMember("default", d);
+            addMember("default", CompactValue(*def->value));
         }
     }
 
     void JSONSchemaVisitor::operator()(const NullElement& e)
     {
-        addMember("type", new NullElement);
+        addMember("type", JSONValue::Null());
     }
 
     void JSONSchemaVisitor::operator()(const StringElement& e)
@@ -506,8 +711,69 @@ namespace refract
         primitiveType(e);
     }
 
+    void JSONSchemaVisitor::define(const std::string& name, const JSONSchemaCache::Fragment& fragment)
+    {
+        if (pDefs->find(name)) {
+            return;
+        }
+
+        JSONValue definition = JSONValue::Object();
+        definition.members = fragment.schema;
+
+        pDefs->add(name, std::move(definition));
+        addDefinitions(fragment.definitions);
+    }
+
+    bool JSONSchemaVisitor::namedType(const ExtendElement& e)
+    {
+        std::string name;
+
+        if (!cache || !NamedTypeUsage(e, name) || HasCircularReference(e)) {
+            return false;
+        }
+
+        const JSONSchemaCache::Fragment* fragment = cache->find(name, fixed, fixedType);
+
+        if (!fragment) {
+            std::unique_ptr<IElement> merged(e.merge());
+
+            if (!merged) {
+                return false;
+            }
+
+            JSONValue definitions = JSONValue::Object();
+            JSONSchemaVisitor renderer(&definitions, fixed, fixedType, cache);
+            Visit(renderer, *merged);
+
+            JSONSchemaCache::Fragment rendered;
+            rendered.schema = std::move(renderer.getOwnership().members);
+            rendered.definitions = std::move(definitions.members);
+            rendered.fixed = renderer.fixed;
+            rendered.fixedType = renderer.fixedType;
+
+            fragment = &cache->add(name, fixed, fixedType, std::move(rendered));
+        }
+
+        if (cache->references() && !fixed && !fixedType && obj.members.empty()) {
+            define(name, *fragment);
+            reference = name;
+        } else {
+            obj.members.insert(obj.members.end(), fragment->schema.begin(), fragment->schema.end());
+            addDefinitions(fragment->definitions);
+        }
+
+        fixed = fragment->fixed;
+        fixedType = fragment->fixedType;
+
+        return true;
+    }
+
     void JSONSchemaVisitor::operator()(const ExtendElement& e)
     {
+        if (namedType(e)) {
+            return;
+        }
+
         IElement* merged = e.merge();
         if (!merged) {
             return;
@@ -519,69 +785,64 @@ namespace refract
 
     void JSONSchemaVisitor::operator()(const OptionElement& e)
     {
-        ObjectElement* props = pObj;
         RefractElements members;
-        ArrayElement::ValueType reqVals;
+        JSONValue::Items reqVals;
         std::vector<MemberElement*> varProps; // TODO: Add variable properties processing
-        RefractElements oneOfMembers;
+        JSONValue::Items oneOfMembers;
         IncludeMembers(e, members);
 
-        processMembers(members, reqVals, varProps, oneOfMembers, props);
+        processMembers(members, reqVals, varProps, oneOfMembers, obj);
 
-        pObj = new ObjectElement;
+        JSONValue props = std::move(obj);
+        obj = JSONValue::Object();
 
-        addMember("properties", props);
+        addMember("properties", std::move(props));
 
         if (!reqVals.empty()) {
-            addMember("required", new ArrayElement(reqVals));
+            addMember("required", JSONValue::Array(std::move(reqVals)));
         }
 
         if (!oneOfMembers.empty()) {
-            addMember("oneOf", new ArrayElement(oneOfMembers));
+            addMember("oneOf", JSONValue::Array(std::move(oneOfMembers)));
         }
     }
 
-    IElement* JSONSchemaVisitor::get()
+    JSONValue& JSONSchemaVisitor::get()
     {
-        return pObj;
+        resolveReference();
+        return obj;
     }
 
-    IElement* JSONSchemaVisitor::getOwnership()
+    JSONValue JSONSchemaVisitor::getOwnership()
     {
-        IElement* ret = pObj;
-        pObj = nullptr;
+        resolveReference();
+        JSONValue ret = std::move(obj);
+        obj = JSONValue::Object();
         return ret;
     }
 
     std::string JSONSchemaVisitor::getSchema(const IElement& e)
     {
-        addMember("$schema", new StringElement("http://json-schema.org/draft-04/schema#"));
+        addMember("$schema", JSONValue::String("http://json-schema.org/draft-04/schema#"));
         setSchemaType("object");
 
         Visit(*this, e);
 
-        if (!pDefs->empty()) {
-            addMember("definitions", pDefs);
-        } else {
-            delete pDefs;
+        if (!pDefs->members.empty()) {
+            addMember("definitions", std::move(*pDefs));
         }
 
-        sos::SerializeJSON s;
-        std::stringstream ss;
-        // FIXME: remove SosSerializeCompactVisitor dependency
-        SosSerializeCompactVisitor sv(false);
-        VisitBy(*pObj, sv);
-
-        s.process(sv.value(), ss);
+        JSONWriter writer;
+        obj.write(writer);
 
-        return ss.str();
+        return writer.str();
     }
 
     void JSONSchemaVisitor::processMembers(const std::vector<refract::IElement*>& members,
-        ArrayElement::ValueType& reqVals,
+        JSONValue::Items& reqVals,
         std::vector<MemberElement*>& varProps,
-        RefractElements& oneOfMembers,
-        ObjectElement* o)
+        JSONValue::Items& oneOfMembers,
+        JSONValue& o)
     {
         std::set<std::string> required;
 
@@ -610,16 +871,12 @@ namespace refract
                     if (IsVariableProperty(*mr->value.first)) {
                         varProps.push_back(mr);
                     } else {
-                        JSONSchemaVisitor renderer(pDefs, fixed);
+                        JSONSchemaVisitor renderer(pDefs, fixed, false, cache);
                         Visit(renderer, *member);
-                        ObjectElement* o1 = TypeQueryVisitor::as<ObjectElement>(renderer.get());
-
-                        if (!o1->value.empty()) {
-                            MemberElement* m1 = TypeQueryVisitor::as<MemberElement>(o1->value[0]->clone());
+                        JSONValue& o1 = renderer.get();
 
-                            if (m1) {
-                                o->push_back(m1);
-                            }
+                        if (!o1.members.empty()) {
+                            o.members.push_back(std::move(o1.members.front()));
                         }
                     }
                 } break;
@@ -630,7 +887,7 @@ namespace refract
                     // FIXME: there is no valid solution for multiple "SelectElement" in one object.
 
                     for (auto const& select : sel->value) {
-                        JSONSchemaVisitor v(pDefs);
+                        JSONSchemaVisitor v(pDefs, false, false, cache);
                         VisitBy(*select, v);
                         oneOfMembers.push_back(v.getOwnership());
                     }
@@ -642,7 +899,7 @@ namespace refract
         }
 
         std::transform(required.begin(), required.end(), std::back_inserter(reqVals), [](const std::string& value) {
-            return IElement::Create(value);
+            return JSONValue::String(value);
         });
     }
 }
@@ -10,7 +10,10 @@
 #define REFRACT_JSONSCHEMAVISITOR_H
 
 #include "VisitorUtils.h"
+#include "JSONValue.h"
+#include "JSONSchemaCache.h"
 #include <string>
+#include <map>
 
 #include "ElementFwd.h"
 
@@ -18,20 +21,27 @@ namespace refract
 {
     class JSONSchemaVisitor
     {
-        ObjectElement* pObj;
-        ObjectElement* pDefs;
+        JSONValue obj;
+        JSONValue defs;
+        JSONValue* pDefs;
         bool fixed;
         bool fixedType;
+        JSONSchemaCache* cache;
+        std::string reference; ///< named type the schema refers to by `$ref`, see `resolveReference()`
 
         void setSchemaType(const std::string& type);
         void addSchemaType(const std::string& type);
         void addNullToEnum();
-        void addMember(const std::string& key, IElement* val);
+        void addMember(const std::string& key, JSONValue&& val);
+        void addDefinitions(const JSONValue::Members& definitions);
+        void resolveReference();
         void anyOf(std::map<std::string, std::vector<IElement*> >& types, std::vector<std::string>& typesOrder);
         bool allItemsEmpty(const ArrayElement::ValueType* val);
-        ObjectElement* definitionFromVariableProperty(JSONSchemaVisitor& renderer);
-        void addVariableProps(std::vector<MemberElement*>& props, ObjectElement* o);
-        ArrayElement* arrayFromProps(std::vector<MemberElement*>& props);
+        JSONValue definitionFromVariableProperty(JSONSchemaVisitor& renderer);
+        void addVariableProps(std::vector<MemberElement*>& props, JSONValue& o);
+        JSONValue arrayFromProps(std::vector<MemberElement*>& props);
+        bool namedType(const ExtendElement& e);
+        void define(const std::string& name, const JSONSchemaCache::Fragment& fragment);
 
         template <typename T>
         void setPrimitiveType(const T& e)
@@ -46,14 +56,19 @@ namespace refract
         void primitiveType(const T& e);
 
         void processMembers(const std::vector<refract::IElement*>& members,
-            ArrayElement::ValueType& reqVals,
+            JSONValue::Items& reqVals,
             std::vector<MemberElement*>& varProps,
-            RefractElements& oneOfMembers,
-            ObjectElement* o);
+            JSONValue::Items& oneOfMembers,
+            JSONValue& o);
+
+        JSONSchemaVisitor(const JSONSchemaVisitor&);
+        JSONSchemaVisitor& operator=(const JSONSchemaVisitor&);
 
     public:
-        JSONSchemaVisitor(ObjectElement* pDefinitions = NULL, bool _fixed = false, bool _fixedType = false);
-        ~JSONSchemaVisitor();
+        JSONSchemaVisitor(JSONValue* pDefinitions = NULL,
+            bool _fixed = false,
+            bool _fixedType = false,
+            JSONSchemaCache* _cache = NULL);
         void setFixed(bool _fixed);
         void setFixedType(bool _fixedType);
         void operator()(const IElement& e);
@@ -70,8 +85,8 @@ namespace refract
 
         void operator()(const OptionElement& e);
 
-        IElement* get();
-        IElement* getOwnership();
+        JSONValue& get();
+        JSONValue getOwnership();
         std::string getSchema(const IElement& e);
     };
 }
@@ -0,0 +1,139 @@
+//
+//  refract/JSONValue.cc
+//  librefract
+//
+
+#include "JSONValue.h"
+#include "JSONWriter.h"
+
+namespace refract
+{
+
+    JSONValue::JSONValue(Type type) : type(type), number(0), boolean(false) {}
+
+    JSONValue JSONValue::Null()
+    {
+        return JSONValue(NullType);
+    }
+
+    JSONValue JSONValue::String(const std::string& value)
+    {
+        JSONValue result(StringType);
+        result.str = value;
+        return result;
+    }
+
+    JSONValue JSONValue::Number(double value)
+    {
+        JSONValue result(NumberType);
+        result.number = value;
+        return result;
+    }
+
+    JSONValue JSONValue::Boolean(bool value)
+    {
+        JSONValue result(BooleanType);
+        result.boolean = value;
+        return result;
+    }
+
+    JSONValue JSONValue::Array(Items&& items)
+    {
+        JSONValue result(ArrayType);
+        result.items = std::move(items);
+        return result;
+    }
+
+    JSONValue JSONValue::Object()
+    {
+        return JSONValue(ObjectType);
+    }
+
+    JSONValue JSONValue::Raw(const std::string& json)
+    {
+        JSONValue result(RawType);
+        result.str = json;
+        return result;
+    }
+
+    void JSONValue::add(const std::string& key, JSONValue&& value)
+    {
+        members.emplace_back(key, std::move(value));
+    }
+
+    void JSONValue::set(const std::string& key, JSONValue&& value)
+    {
+        if (JSONValue* member = find(key)) {
+            *member = std::move(value);
+        } else {
+            add(key, std::move(value));
+        }
+    }
+
+    void JSONValue::push(JSONValue&& value)
+    {
+        items.push_back(std::move(value));
+    }
+
+    JSONValue* JSONValue::find(const std::string& key)
+    {
+        for (Members::iterator it = members.begin(); it != members.end(); ++it) {
+            if (it->first == key) {
+                return &it->second;
+            }
+        }
+
+        return NULL;
+    }
+
+    void JSONValue::write(JSONWriter& writer) const
+    {
+        switch (type) {
+            case NullType:
+                writer.null();
+                break;
+
+            case StringType:
+                writer.string(str);
+                break;
+
+            case NumberType:
+                writer.number(number);
+                break;
+
+            case BooleanType:
+                writer.boolean(boolean);
+                break;
+
+            case ArrayType:
+                writer.beginArray();
+
+                for (Items::const_iterator it = items.begin(); it != items.end(); ++it) {
+                    writer.item();
+                    it->write(writer);
+                }
+
+                writer.endArray();
+                break;
+
+            case ObjectType:
+                writer.beginObject();
+
+                for (Members::const_iterator it = members.begin(); it != members.end(); ++it) {
+                    writer.key(it->first);
+                    it->second.write(writer);
+                }
+
+                writer.endObject();
+                break;
+
+            case RawType:
+                writer.raw(str);
+                break;
+
+            case UndefinedType:
+                break;
+        }
+    }
+
+}; // namespace refract
@@ -0,0 +1,76 @@
+//
+//  refract/JSONValue.h
+//  librefract
+//
+#ifndef REFRACT_JSONVALUE_H
+#define REFRACT_JSONVALUE_H
+
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace refract
+{
+
+    class JSONWriter;
+
+    /**
+     * Lightweight JSON value
+     *
+     * Used to assemble JSON documents which need to be amended
+     * before they are written (e.g. JSON Schema). Values are moved
+     * into containers, members of objects are appended and a key
+     * repeated in one object is resolved by `JSONWriter` on write.
+     */
+    struct JSONValue {
+        typedef enum {
+            UndefinedType = 0,
+            NullType,
+            StringType,
+            NumberType,
+            BooleanType,
+            ArrayType,
+            ObjectType,
+            RawType ///< already serialized JSON, see `Raw()`
+        } Type;
+
+        typedef std::vector<JSONValue> Items;
+        typedef std::vector<std::pair<std::string, JSONValue> > Members;
+
+        Type type;
+        std::string str;
+        double number;
+        bool boolean;
+        Items items;
+        Members members;
+
+        explicit JSONValue(Type type = UndefinedType);
+
+        static JSONValue Null();
+        static JSONValue String(const std::string& value);
+        static JSONValue Number(double value);
+        static JSONValue Boolean(bool value);
+        static JSONValue Array(Items&& items = Items());
+        static JSONValue Object();
+
+        /** Value serialized by `JSONWriter` at top level */
+        static JSONValue Raw(const std::string& json);
+
+        /** Append member to object */
+        void add(const std::string& key, JSONValue&& value);
+
+        /** Set member of object, value of a key already present is replaced in place */
+        void set(const std::string& key, JSONValue&& value);
+
+        /** Append item to array */
+        void push(JSONValue&& value);
+
+        /** First member of object with key, NULL if there is none */
+        JSONValue* find(const std::string& key);
+
+        void write(JSONWriter& writer) const;
+    };
+
+}; // namespace refract
+
+#endif // #ifndef REFRACT_JSONVALUE_H
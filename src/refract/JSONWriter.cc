@@ -0,0 +1,318 @@
+//
+//  refract/JSONWriter.cc
+//  librefract
+//
+
+#include "JSONWriter.h"
+
+#include <locale>
+#include <sstream>
+
+namespace refract
+{
+
+    namespace
+    {
+        const size_t NoEntry = static_cast<size_t>(-1);
+
+        /** Objects with at least this many keys look duplicates up in an index */
+        const size_t IndexedEntries = 16;
+
+        /** Stream formatting numbers independently of global and C locale */
+        struct ClassicStream : std::ostringstream {
+            ClassicStream()
+            {
+                imbue(std::locale::classic());
+            }
+        };
+    }
+
+    void JSONWriter::indent(size_t level)
+    {
+        out_.append(level * 2, ' ');
+    }
+
+    void JSONWriter::escape(const std::string& str)
+    {
+        std::string::size_type done = 0;
+
+        for (std::string::size_type i = 0; i < str.size(); ++i) {
+            const char* escaped;
+
+            switch (str[i]) {
+                case '\\':
+                    escaped = "\\\\";
+                    break;
+                case '"':
+                    escaped = "\\\"";
+                    break;
+                case '\n':
+                    escaped = "\\n";
+                    break;
+                default:
+                    continue;
+            }
+
+            out_.append(str, done, i - done);
+            out_.append(escaped);
+            done = i + 1;
+        }
+
+        out_.append(str, done, std::string::npos);
+    }
+
+    void JSONWriter::separate()
+    {
+        if (frames_.empty()) {
+            return;
+        }
+
+        Frame& frame = frames_.back();
+
+        out_.append(frame.count ? ",\n" : "\n");
+        indent(frames_.size());
+
+        ++frame.count;
+    }
+
+    void JSONWriter::finishDuplicate()
+    {
+        if (frames_.empty() || !frames_.back().object || entries_.size() <= frames_.back().entries
+            || entries_.back().duplicateOf == NoEntry) {
+            return;
+        }
+
+        Entry duplicate = entries_.back();
+        entries_.pop_back();
+        --frames_.back().count;
+
+        // move value of repeated key in place of the value of its first occurrence
+        std::string value = out_.substr(duplicate.valueBegin);
+        out_.resize(duplicate.begin);
+
+        Entry& first = entries_[duplicate.duplicateOf];
+        size_t next = duplicate.duplicateOf + 1;
+        size_t end = next < entries_.size() ? entries_[next].begin : out_.size();
+        size_t replaced = end - first.valueBegin;
+
+        out_.replace(first.valueBegin, replaced, value);
+
+        // shift entries following the replaced value (modular arithmetic)
+        for (size_t i = next; i < entries_.size(); ++i) {
+            Entry& entry = entries_[i];
+            entry.begin += value.size() - replaced;
+            entry.keyBegin += value.size() - replaced;
+            entry.keyEnd += value.size() - replaced;
+            entry.valueBegin += value.size() - replaced;
+        }
+    }
+
+    void JSONWriter::beginObject()
+    {
+        out_.push_back('{');
+
+        Frame frame = { true, 0, entries_.size(), false };
+        frames_.push_back(frame);
+    }
+
+    void JSONWriter::endObject()
+    {
+        finishDuplicate();
+
+        Frame frame = frames_.back();
+        frames_.pop_back();
+        entries_.resize(frame.entries);
+
+        if (frame.count) {
+            out_.push_back('\n');
+            indent(frames_.size());
+        }
+
+        out_.push_back('}');
+    }
+
+    void JSONWriter::beginArray()
+    {
+        out_.push_back('[');
+
+        Frame frame = { false, 0, entries_.size(), false };
+        frames_.push_back(frame);
+    }
+
+    void JSONWriter::endArray()
+    {
+        Frame frame = frames_.back();
+        frames_.pop_back();
+
+        if (frame.count) {
+            out_.push_back('\n');
+            indent(frames_.size());
+        }
+
+        out_.push_back(']');
+    }
+
+    void JSONWriter::key(const std::string& key)
+    {
+        finishDuplicate();
+
+        Entry entry;
+        entry.begin = out_.size();
+
+        separate();
+
+        out_.push_back('"');
+        entry.keyBegin = out_.size();
+        escape(key);
+        entry.keyEnd = out_.size();
+        out_.append("\": ");
+        entry.valueBegin = out_.size();
+        entry.duplicateOf = NoEntry;
+
+        Frame& frame = frames_.back();
+
+        if (!frame.indexed && entries_.size() - frame.entries >= IndexedEntries) {
+            indexKeys();
+        }
+
+        entry.duplicateOf = frame.indexed ? findIndexedKey(entry) : findKey(entry);
+
+        entries_.push_back(entry);
+    }
+
+    bool JSONWriter::sameKey(const Entry& entry, const Entry& other) const
+    {
+        const size_t length = entry.keyEnd - entry.keyBegin;
+
+        return other.keyEnd - other.keyBegin == length
+            && out_.compare(other.keyBegin, length, out_, entry.keyBegin, length) == 0;
+    }
+
+    size_t JSONWriter::findKey(const Entry& entry) const
+    {
+        for (size_t i = frames_.back().entries; i < entries_.size(); ++i) {
+            if (sameKey(entry, entries_[i])) {
+                return i;
+            }
+        }
+
+        return NoEntry;
+    }
+
+    void JSONWriter::indexKeys()
+    {
+        Frame& frame = frames_.back();
+        const size_t level = frames_.size() - 1;
+
+        if (indexes_.size() <= level) {
+            indexes_.resize(level + 1);
+        }
+
+        KeyIndex& index = indexes_[level];
+        index.clear();
+
+        // duplicates are relocated as soon as they are finished, so keys are unique
+        for (size_t i = frame.entries; i < entries_.size(); ++i) {
+            const Entry& entry = entries_[i];
+            index.emplace(out_.substr(entry.keyBegin, entry.keyEnd - entry.keyBegin), i);
+        }
+
+        frame.indexed = true;
+    }
+
+    size_t JSONWriter::findIndexedKey(const Entry& entry)
+    {
+        KeyIndex& index = indexes_[frames_.size() - 1];
+        const size_t added = entries_.size();
+
+        std::pair<KeyIndex::iterator, bool> found
+            = index.emplace(out_.substr(entry.keyBegin, entry.keyEnd - entry.keyBegin), added);
+
+        if (found.second) {
+            return NoEntry;
+        }
+
+        size_t i = found.first->second;
+
+        // entries dropped by rollback() may be left in index
+        if (i < added && sameKey(entry, entries_[i])) {
+            return i;
+        }
+
+        found.first->second = added;
+        return NoEntry;
+    }
+
+    void JSONWriter::item()
+    {
+        separate();
+    }
+
+    bool JSONWriter::inObject() const
+    {
+        return !frames_.empty() && frames_.back().object;
+    }
+
+    void JSONWriter::string(const std::string& value)
+    {
+        out_.push_back('"');
+        escape(value);
+        out_.push_back('"');
+    }
+
+    void JSONWriter::number(double value)
+    {
+        // default formatting of `std::ostream` as used by `sos::SerializeJSON`,
+        // in classic locale so the decimal point is always '.'
+        thread_local ClassicStream stream;
+
+        stream.str(std::string());
+        stream << value;
+
+        out_.append(stream.str());
+    }
+
+    void JSONWriter::boolean(bool value)
+    {
+        out_.append(value ? "true" : "false");
+    }
+
+    void JSONWriter::null()
+    {
+        out_.append("null");
+    }
+
+    void JSONWriter::raw(const std::string& json)
+    {
+        std::string::size_type done = 0;
+        std::string::size_type eol;
+
+        // strings are escaped, so any newline is a line break of the layout
+        while ((eol = json.find('\n', done)) != std::string::npos) {
+            out_.append(json, done, eol + 1 - done);
+            indent(frames_.size());
+            done = eol + 1;
+        }
+
+        out_.append(json, done, std::string::npos);
+    }
+
+    JSONWriter::Mark JSONWriter::mark()
+    {
+        finishDuplicate();
+
+        Mark mark = { out_.size(), frames_.empty() ? 0 : frames_.back().count, entries_.size() };
+        return mark;
+    }
+
+    void JSONWriter::rollback(const Mark& mark)
+    {
+        out_.resize(mark.size);
+        entries_.resize(mark.entries);
+
+        if (!frames_.empty()) {
+            frames_.back().count = mark.count;
+        }
+    }
+
+}; // namespace refract
@@ -0,0 +1,106 @@
+//
+//  refract/JSONWriter.h
+//  librefract
+//
+#ifndef REFRACT_JSONWRITER_H
+#define REFRACT_JSONWRITER_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+
+namespace refract
+{
+
+    /**
+     * Streaming JSON writer
+     *
+     * Writes the same layout as `sos::SerializeJSON` does, without
+     * building any intermediate tree. As with `sos::Object`, a key
+     * repeated in one object keeps the position of its first
+     * occurrence and the value of the last one.
+     *
+     * Values in an object are preceded by `key()`, values in an array
+     * by `item()`. Anything written after `mark()` at the same nesting
+     * level may be dropped by `rollback()`.
+     */
+    class JSONWriter
+    {
+    public:
+        struct Mark {
+            size_t size;
+            size_t count;
+            size_t entries;
+        };
+
+    private:
+        struct Frame {
+            bool object;
+            size_t count;
+            size_t entries; // first entry of object in `entries_`
+            bool indexed;   // keys of object are in `indexes_`
+        };
+
+        struct Entry {
+            size_t begin; // item separator
+            size_t keyBegin;
+            size_t keyEnd;
+            size_t valueBegin;
+            size_t duplicateOf;
+        };
+
+        /** Entry of key in object with many keys */
+        typedef std::unordered_map<std::string, size_t> KeyIndex;
+
+        std::string out_;
+        std::vector<Frame> frames_;
+        std::vector<Entry> entries_;
+        std::vector<KeyIndex> indexes_; // by nesting level, reused
+
+        void separate();
+        void indent(size_t level);
+        void escape(const std::string& str);
+        void finishDuplicate();
+
+        bool sameKey(const Entry& entry, const Entry& other) const;
+        size_t findKey(const Entry& entry) const;
+        size_t findIndexedKey(const Entry& entry);
+        void indexKeys();
+
+    public:
+        void beginObject();
+        void endObject();
+
+        void beginArray();
+        void endArray();
+
+        /** Start member of currently written object */
+        void key(const std::string& key);
+
+        /** Start item of currently written array */
+        void item();
+
+        /** True if object is written at current level */
+        bool inObject() const;
+
+        void string(const std::string& value);
+        void number(double value);
+        void boolean(bool value);
+        void null();
+
+        /** Insert JSON serialized by another writer at top level */
+        void raw(const std::string& json);
+
+        Mark mark();
+        void rollback(const Mark& mark);
+
+        const std::string& str() const
+        {
+            return out_;
+        }
+    };
+
+}; // namespace refract
+
+#endif // #ifndef REFRACT_JSONWRITER_H
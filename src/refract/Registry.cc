@@ -8,29 +8,21 @@
 
 #include "Registry.h"
 #include "Element.h"
-#include "SerializeCompactVisitor.h"
 #include "TypeQueryVisitor.h"
 
-#include <algorithm>
-
 namespace refract
 {
 
     IElement* FindRootAncestor(const std::string& name, const Registry& registry)
     {
-        IElement* parent = registry.find(name);
-
-        while (parent && !isReserved(parent->element())) {
-            IElement* next = registry.find(parent->element());
+        return registry.findRoot(name);
+    }
 
-            if (!next || (next == parent)) {
-                return parent;
-            }
+    Registry::Registry() : resolved(false) {}
 
-            parent = next;
-        }
-
-        return parent;
+    Registry::~Registry()
+    {
+        clearAll();
     }
 
     std::string Registry::getElementId(IElement* element)
@@ -41,10 +33,6 @@ namespace refract
             throw LogicError("Element has no ID");
         }
 
-        // FIXME: remove dependecy on SosSerializeCompactVisitor
-        SosSerializeCompactVisitor v;
-        VisitBy(*(*it)->value.second, v);
-
         if (StringElement* s = TypeQueryVisitor::as<StringElement>((*it)->value.second)) {
             return s->value;
         }
@@ -52,6 +40,23 @@ namespace refract
         throw LogicError("Value of element meta 'id' is not StringElement");
     }
 
+    IElement* Registry::walkRootAncestor(const std::string& name) const
+    {
+        IElement* parent = find(name);
+
+        while (parent && !isReserved(parent->symbol())) {
+            IElement* next = find(parent->element());
+
+            if (!next || (next == parent)) {
+                return parent;
+            }
+
+            parent = next;
+        }
+
+        return parent;
+    }
+
     IElement* Registry::find(const std::string& name) const
     {
         Map::const_iterator i = registrated.find(name);
@@ -60,29 +65,61 @@ namespace refract
             return NULL;
         }
 
-        return i->second;
+        return i->second.element;
     }
 
-    bool Registry::add(IElement* element)
+    IElement* Registry::findRoot(const std::string& name) const
     {
-        IElement::MemberElementCollection::const_iterator it = element->meta.find("id");
+        if (!resolved) {
+            return walkRootAncestor(name);
+        }
 
-        if (it == element->meta.end()) {
-            throw LogicError("Element has no ID");
+        Map::const_iterator i = registrated.find(name);
+
+        if (i == registrated.end()) {
+            return NULL;
         }
 
+        return i->second.root;
+    }
+
+    TypeQueryVisitor::ElementType Registry::findRootType(const std::string& name) const
+    {
+        if (!resolved) {
+            IElement* root = walkRootAncestor(name);
+
+            if (!root) {
+                return TypeQueryVisitor::Unknown;
+            }
+
+            TypeQueryVisitor query;
+            VisitBy(*root, query);
+            return query.get();
+        }
+
+        Map::const_iterator i = registrated.find(name);
+
+        if (i == registrated.end()) {
+            return TypeQueryVisitor::Unknown;
+        }
+
+        return i->second.rootType;
+    }
+
+    bool Registry::add(IElement* element)
+    {
         std::string id = getElementId(element);
 
         if (isReserved(id)) {
             throw LogicError("You can not register a basic element");
         }
 
-        if (find(id)) {
+        if (!registrated.insert(Map::value_type(id, Entry(element))).second) {
             // there is already already element with given name
             return false;
         }
 
-        registrated[id] = element;
+        resolved = false;
         return true;
     }
 
@@ -94,23 +131,39 @@ namespace refract
             return false;
         }
 
+        delete i->second.element;
         registrated.erase(i);
+
+        resolved = false;
         return true;
     }
 
-    template <typename T>
-    static void DeleteSecond(T& pair)
+    void Registry::clearAll()
     {
-        delete pair.second;
+        for (Map::iterator i = registrated.begin(); i != registrated.end(); ++i) {
+            delete i->second.element;
+        }
+
+        registrated.clear();
+        resolved = false;
     }
 
-    void Registry::clearAll(bool releaseElements)
+    void Registry::resolve()
     {
-        if (releaseElements) {
-            std::for_each(registrated.begin(), registrated.end(), DeleteSecond<Map::value_type>);
+        for (Map::iterator i = registrated.begin(); i != registrated.end(); ++i) {
+            Entry& entry = i->second;
+
+            entry.root = walkRootAncestor(i->first);
+            entry.rootType = TypeQueryVisitor::Unknown;
+
+            if (entry.root) {
+                TypeQueryVisitor query;
+                VisitBy(*entry.root, query);
+                entry.rootType = query.get();
+            }
         }
 
-        registrated.clear();
+        resolved = true;
     }
 
 }; // namespace refract
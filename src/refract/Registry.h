@@ -8,31 +8,68 @@
 #ifndef REFRACT_REGISTRY_H
 #define REFRACT_REGISTRY_H
 
-#include <map>
+#include <unordered_map>
 #include <string>
 
+#include "TypeQueryVisitor.h"
+
 namespace refract
 {
 
     // Forward declarations of IElement
     struct IElement;
 
+    /**
+     * Named types registry
+     *
+     * Registry owns registered elements, they are released on
+     * `remove()`, `clearAll()` and destruction of the registry.
+     * Element rejected by `add()` stays owned by the caller.
+     *
+     * Root ancestors of registered types are resolved by `resolve()`
+     * once registration finishes. Until then and after any change of
+     * the registry they are looked up by walking the inheritance chain.
+     */
     class Registry
     {
-        // FIXME: potentionally dangerous,
-        // if element is deleted and not removed from registry
-        // solution: std::shared_ptr<> || std::weak_ptr<>
-        typedef std::map<std::string, IElement*> Map;
+        struct Entry {
+            IElement* element;
+
+            /** Resolved root ancestor and its base type */
+            IElement* root;
+            TypeQueryVisitor::ElementType rootType;
+
+            Entry(IElement* element) : element(element), root(NULL), rootType(TypeQueryVisitor::Unknown) {}
+        };
+
+        typedef std::unordered_map<std::string, Entry> Map;
         Map registrated;
+        bool resolved;
 
         std::string getElementId(IElement* element);
+        IElement* walkRootAncestor(const std::string& name) const;
+
+        Registry(const Registry&);
+        Registry& operator=(const Registry&);
 
     public:
+        Registry();
+        ~Registry();
+
         IElement* find(const std::string& name) const;
 
+        /** Root ancestor of named type, NULL if not registered */
+        IElement* findRoot(const std::string& name) const;
+
+        /** Base type of root ancestor of named type, `Unknown` if not registered */
+        TypeQueryVisitor::ElementType findRootType(const std::string& name) const;
+
         bool add(IElement* element);
         bool remove(const std::string& name);
-        void clearAll(bool releaseElements = false);
+        void clearAll();
+
+        /** Resolve root ancestors of all registered types */
+        void resolve();
     };
 
     IElement* FindRootAncestor(const std::string& name, const Registry& registry);
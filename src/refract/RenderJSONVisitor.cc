@@ -7,9 +7,6 @@
 //
 
 #include "VisitorUtils.h"
-#include "sosJSON.h"
-#include <sstream>
-#include "SerializeCompactVisitor.h"
 
 #include "RenderJSONVisitor.h"
 
@@ -18,50 +15,94 @@ namespace refract
 
     namespace
     {
+        void WriteValue(JSONWriter& writer, const std::string& value)
+        {
+            writer.string(value);
+        }
 
-        template <typename T>
-        void FetchMembers(const T& element, typename T::ValueType& members)
+        void WriteValue(JSONWriter& writer, double value)
         {
-            const typename T::ValueType* val = GetValue<T>(element);
+            writer.number(value);
+        }
 
-            if (!val) {
-                return;
-            }
+        void WriteValue(JSONWriter& writer, bool value)
+        {
+            writer.boolean(value);
+        }
+    }
 
-            for (auto const& item : *val) {
+    RenderJSONVisitor::RenderJSONVisitor() : writer(own), item(false), rendered(false) {}
 
-                if (!item || item->empty()) {
-                    continue;
-                }
+    RenderJSONVisitor::RenderJSONVisitor(JSONWriter& writer) : writer(writer), item(false), rendered(false) {}
 
-                if (RefElement* ref = TypeQueryVisitor::as<RefElement>(item)) {
-                    HandleRefWhenFetchingMembers<T>(ref, members, FetchMembers<T>);
-                    continue;
-                } else if (SelectElement* select = TypeQueryVisitor::as<SelectElement>(item)) {
-                    if (select->value.empty() || !(*select->value.begin())) {
-                        continue;
-                    }
+    RenderJSONVisitor::RenderJSONVisitor(JSONWriter& writer, bool item) : writer(writer), item(item), rendered(false)
+    {
+    }
 
-                    FetchMembers(*(*select->value.begin()), members);
-                    continue;
-                }
+    void RenderJSONVisitor::open(const std::string& key)
+    {
+        rendered = true;
+
+        if (!item) {
+            return;
+        }
 
-                RenderJSONVisitor renderer;
-                Visit(renderer, *item);
-                IElement* e = renderer.getOwnership();
+        if (writer.inObject()) {
+            writer.key(key);
+        } else {
+            writer.item();
+        }
+    }
 
-                if (!e) {
+    template <typename T>
+    void RenderJSONVisitor::members(const T& element)
+    {
+        const typename T::ValueType* val = GetValue<T>(element);
+
+        if (!val) {
+            return;
+        }
+
+        for (auto const& value : *val) {
+
+            if (!value || value->empty()) {
+                continue;
+            }
+
+            if (RefElement* ref = TypeQueryVisitor::as<RefElement>(value)) {
+                HandleResolvedRef<T>(ref, [this](const T& resolved) { members(resolved); });
+                continue;
+            } else if (SelectElement* select = TypeQueryVisitor::as<SelectElement>(value)) {
+                if (select->value.empty() || !(*select->value.begin())) {
                     continue;
                 }
 
-                members.push_back(e);
+                members(*(*select->value.begin()));
+                continue;
+            }
+
+            JSONWriter::Mark mark = writer.mark();
+
+            RenderJSONVisitor renderer(writer, true);
+            Visit(renderer, *value);
+
+            if (!renderer.rendered) {
+                writer.rollback(mark);
             }
         }
     }
 
-    RenderJSONVisitor::~RenderJSONVisitor()
+    template <typename T>
+    void RenderJSONVisitor::primitive(const T& e)
     {
-        delete result;
+        const typename T::ValueType* v = GetValue<T>(e);
+
+        if (!v) {
+            return;
+        }
+
+        open();
+        WriteValue(writer, *v);
     }
 
     void RenderJSONVisitor::operator()(const IElement& e)
@@ -74,140 +115,109 @@ namespace refract
 
         std::string key = GetKeyAsString(e);
 
-        if (key.empty()) {
+        if (key.empty() || !e.value.second) {
             return;
         }
 
-        RenderJSONVisitor renderer;
-
-        if (e.value.second) {
-            if (EnumElement* enm = TypeQueryVisitor::as<EnumElement>(e.value.second)) {
-                // We need to handle Enum individualy because of attr["enumerations"]
-                Visit(renderer, *enm);
-            } else if (IsTypeAttribute(e, "nullable") && e.value.second->empty()) {
-                renderer.result = new NullElement;
-            } else if (IsTypeAttribute(e, "optional") && e.value.second->empty()) {
+        // We need to handle Enum individualy because of attr["enumerations"]
+        if (!TypeQueryVisitor::as<EnumElement>(e.value.second) && e.value.second->empty()) {
+            if (IsTypeAttribute(e, "nullable")) {
+                open(key);
+                writer.null();
+                return;
+            } else if (IsTypeAttribute(e, "optional")) {
                 return;
-            } else {
-                Visit(renderer, *e.value.second);
             }
         }
 
-        if (!renderer.result) {
-            return;
-        }
+        open(key);
+
+        RenderJSONVisitor renderer(writer);
+        Visit(renderer, *e.value.second);
 
-        result = new MemberElement(key, renderer.result ? renderer.getOwnership() : new StringElement);
+        rendered = renderer.rendered;
     }
 
     void RenderJSONVisitor::operator()(const ObjectElement& e)
     {
-        ObjectElement::ValueType members;
-        FetchMembers(e, members);
-        ObjectElement* o = new ObjectElement;
-        o->set(members);
-        result = o;
+        open();
+
+        writer.beginObject();
+        members(e);
+        writer.endObject();
     }
 
     void RenderJSONVisitor::operator()(const EnumElement& e)
     {
 
         const IElement* val = GetValue<EnumElement>(e);
-        if (val && !val->empty()) {
-            val = val->clone();
-        } else {
-            val = new StringElement;
+
+        if (!val || val->empty()) {
+            open();
+            writer.string(std::string());
+            return;
         }
 
-        RenderJSONVisitor renderer;
+        RenderJSONVisitor renderer(writer, item);
         VisitBy(*val, renderer);
-        result = renderer.getOwnership();
 
-        delete val;
+        rendered = renderer.rendered;
     }
 
     void RenderJSONVisitor::operator()(const ArrayElement& e)
     {
-        ArrayElement::ValueType members;
-        FetchMembers(e, members);
-        ArrayElement* a = new ArrayElement;
-        a->set(members);
-        result = a;
+        open();
+
+        writer.beginArray();
+        members(e);
+        writer.endArray();
     }
 
     void RenderJSONVisitor::operator()(const NullElement& e)
     {
-        result = new NullElement;
-    }
-
-    template <typename T>
-    IElement* getResult(const T& e)
-    {
-        const typename T::ValueType* v = GetValue<T>(e);
-
-        if (!v) {
-            return nullptr;
-        }
-
-        T* result = IElement::Create(*v);
-
-        return result;
+        open();
+        writer.null();
     }
 
     void RenderJSONVisitor::operator()(const StringElement& e)
     {
-        result = getResult(e);
+        primitive(e);
     }
 
     void RenderJSONVisitor::operator()(const NumberElement& e)
     {
-        result = getResult(e);
+        primitive(e);
     }
 
     void RenderJSONVisitor::operator()(const BooleanElement& e)
     {
-        result = getResult(e);
+        primitive(e);
     }
 
     void RenderJSONVisitor::operator()(const ExtendElement& e)
     {
 
-        RenderJSONVisitor renderer;
         IElement* merged = e.merge();
 
         if (!merged) {
             return;
         }
 
+        RenderJSONVisitor renderer(writer, item);
         Visit(renderer, *merged);
-        result = renderer.getOwnership();
+
+        rendered = renderer.rendered;
 
         delete merged;
     }
 
-    IElement* RenderJSONVisitor::getOwnership()
+    bool RenderJSONVisitor::empty() const
     {
-        IElement* ret = result;
-        result = nullptr;
-        return ret;
+        return !rendered;
     }
 
     std::string RenderJSONVisitor::getString() const
     {
-        std::string out;
-
-        if (result) {
-            sos::SerializeJSON serializer;
-            std::stringstream ss;
-
-            // FIXME: remove SosSerializeCompactVisitor dependency
-            SosSerializeCompactVisitor s;
-            VisitBy(*result, s);
-            serializer.process(s.value(), ss);
-
-            return ss.str();
-        }
-
-        return out;
+        return writer.str();
     }
 }
@@ -9,21 +9,51 @@
 #ifndef REFRACT_RENDERJSONVISITOR_H
 #define REFRACT_RENDERJSONVISITOR_H
 
-#include "sos.h"
 #include <string>
 
 #include "ElementFwd.h"
+#include "JSONWriter.h"
 
 namespace refract
 {
 
+    /**
+     * Renders sample JSON value of (expanded) element
+     *
+     * JSON is written directly by `JSONWriter` while walking the
+     * element, either into own buffer (see `getString()`) or into
+     * an external writer as its next value.
+     */
     class RenderJSONVisitor
     {
-        IElement* result = nullptr;
+        JSONWriter own;
+        JSONWriter& writer;
+
+        /** Value is item of array/object being written */
+        bool item;
+
+        /** Anything was written */
+        bool rendered;
+
+        RenderJSONVisitor(JSONWriter& writer, bool item);
+        RenderJSONVisitor(const RenderJSONVisitor&);
+        RenderJSONVisitor& operator=(const RenderJSONVisitor&);
+
+        /** Start value in writer, with `key` if written into object */
+        void open(const std::string& key = std::string());
+
+        template <typename T>
+        void primitive(const T& e);
+
+        /** Write members of array/object as its items */
+        template <typename T>
+        void members(const T& e);
 
     public:
-        RenderJSONVisitor() = default;
-        virtual ~RenderJSONVisitor();
+        RenderJSONVisitor();
+
+        /** Render as next value of writer, already started by `key()` or `item()` */
+        explicit RenderJSONVisitor(JSONWriter& writer);
 
         void operator()(const IElement& e);
         void operator()(const MemberElement& e);
@@ -44,8 +74,10 @@ namespace refract
         // void operator()(const OptionElement& e);
         // void operator()(const SelectElement& e);
 
+        /** True if nothing was rendered */
+        bool empty() const;
+
         std::string getString() const;
-        IElement* getOwnership();
     };
 }
 
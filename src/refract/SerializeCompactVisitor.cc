@@ -12,52 +12,59 @@
 namespace refract
 {
 
-    void SosSerializeCompactVisitor::operator()(const IElement& e)
+    template <typename T>
+    void SerializeCompactVisitor<T>::operator()(const IElement& e)
     {
         throw NotImplemented("NI: IElement Compact Serialization");
     }
 
-    void SosSerializeCompactVisitor::operator()(const HolderElement& e)
+    template <typename T>
+    void SerializeCompactVisitor<T>::operator()(const HolderElement& e)
     {
         throw NotImplemented("NI: DirectElement Compact Serialization");
     }
 
-    void SosSerializeCompactVisitor::operator()(const NullElement& e)
+    template <typename T>
+    void SerializeCompactVisitor<T>::operator()(const NullElement& e)
     {
-        value_ = sos::Null();
+        value_ = Traits::Null();
     }
 
-    void SosSerializeCompactVisitor::operator()(const StringElement& e)
+    template <typename T>
+    void SerializeCompactVisitor<T>::operator()(const StringElement& e)
     {
-        value_ = sos::String(e.value);
+        value_ = Traits::String(e.value);
     }
 
-    void SosSerializeCompactVisitor::operator()(const NumberElement& e)
+    template <typename T>
+    void SerializeCompactVisitor<T>::operator()(const NumberElement& e)
     {
-        value_ = sos::Number(e.value);
+        value_ = Traits::Number(e.value);
     }
 
-    void SosSerializeCompactVisitor::operator()(const BooleanElement& e)
+    template <typename T>
+    void SerializeCompactVisitor<T>::operator()(const BooleanElement& e)
     {
-        value_ = sos::Boolean(e.value);
+        value_ = Traits::Boolean(e.value);
     }
 
-    namespace
+    template <typename T>
+    template <typename Values>
+    void SerializeCompactVisitor<T>::serializeValues(const Values& values)
     {
+        T array = Traits::Array();
 
-        template <typename Values>
-        void SerializeValues(sos::Array& array, const Values& values, bool generateSourceMap)
-        {
-
-            for (auto const& value : values) {
-                SosSerializeCompactVisitor s(generateSourceMap);
-                VisitBy(*value, s);
-                array.push(s.value());
-            }
+        for (auto const& value : values) {
+            SerializeCompactVisitor s(generateSourceMap);
+            VisitBy(*value, s);
+            Traits::push(array, std::move(s.value_));
         }
+
+        value_ = std::move(array);
     }
 
-    void SosSerializeCompactVisitor::operator()(const EnumElement& e)
+    template <typename T>
+    void SerializeCompactVisitor<T>::operator()(const EnumElement& e)
     {
         auto enums = e.attributes.find("enumerations");
         if (enums == e.attributes.end() || !(*enums)->value.second) {
@@ -67,19 +74,19 @@ namespace refract
         VisitBy(*(*enums)->value.second, *this);
     }
 
-    void SosSerializeCompactVisitor::operator()(const ArrayElement& e)
+    template <typename T>
+    void SerializeCompactVisitor<T>::operator()(const ArrayElement& e)
     {
-        sos::Array array;
-        SerializeValues(array, e.value, generateSourceMap);
-        value_ = array;
+        serializeValues(e.value);
     }
 
-    void SosSerializeCompactVisitor::operator()(const MemberElement& e)
+    template <typename T>
+    void SerializeCompactVisitor<T>::operator()(const MemberElement& e)
     {
         if (e.value.first) {
-            SosSerializeCompactVisitor s(generateSourceMap);
+            SerializeCompactVisitor s(generateSourceMap);
             VisitBy(*e.value.first, s);
-            key_ = s.value().str;
+            key_ = s.value_.str;
         }
 
         if (e.value.second) {
@@ -87,41 +94,45 @@ namespace refract
         }
     }
 
-    void SosSerializeCompactVisitor::operator()(const ObjectElement& e)
+    template <typename T>
+    void SerializeCompactVisitor<T>::operator()(const ObjectElement& e)
     {
-        sos::Object obj;
+        T obj = Traits::Object();
 
         for (auto const& value : e.value) {
-            SosSerializeCompactVisitor sv(generateSourceMap);
+            SerializeCompactVisitor sv(generateSourceMap);
             VisitBy(*value, sv);
-            obj.set(sv.key(), sv.value());
+            Traits::set(obj, sv.key_, std::move(sv.value_));
         }
 
-        value_ = obj;
+        value_ = std::move(obj);
     }
 
-    void SosSerializeCompactVisitor::operator()(const RefElement& e)
+    template <typename T>
+    void SerializeCompactVisitor<T>::operator()(const RefElement& e)
     {
         throw NotImplemented("NI: RefElement Compact Serialization");
     }
 
-    void SosSerializeCompactVisitor::operator()(const ExtendElement& e)
+    template <typename T>
+    void SerializeCompactVisitor<T>::operator()(const ExtendElement& e)
     {
         throw NotImplemented("ExtendElement serialization Not Implemented");
     }
 
-    void SosSerializeCompactVisitor::operator()(const OptionElement& e)
+    template <typename T>
+    void SerializeCompactVisitor<T>::operator()(const OptionElement& e)
     {
-        sos::Array array;
-        SerializeValues(array, e.value, generateSourceMap);
-        value_ = array;
+        serializeValues(e.value);
     }
 
-    void SosSerializeCompactVisitor::operator()(const SelectElement& e)
+    template <typename T>
+    void SerializeCompactVisitor<T>::operator()(const SelectElement& e)
     {
-        sos::Array array;
-        SerializeValues(array, e.value, generateSourceMap);
-        value_ = array;
+        serializeValues(e.value);
     }
 
+    template class SerializeCompactVisitor<sos::Base>;
+    template class SerializeCompactVisitor<JSONValue>;
+
 }; // namespace refract
@@ -9,22 +9,127 @@
 #define REFRACT_SERIALIZECOMPACTVISITOR_H
 
 #include "sos.h"
+#include "JSONValue.h"
 #include <string>
+#include <utility>
 
 #include "ElementFwd.h"
 
 namespace refract
 {
 
-    class SosSerializeCompactVisitor
+    /**
+     * How `SerializeCompactVisitor` builds values of type `T`
+     */
+    template <typename T>
+    struct CompactValueTraits;
+
+    template <>
+    struct CompactValueTraits<sos::Base> {
+        static sos::Base Null()
+        {
+            return sos::Null();
+        }
+
+        static sos::Base String(const std::string& value)
+        {
+            return sos::String(value);
+        }
+
+        static sos::Base Number(double value)
+        {
+            return sos::Number(value);
+        }
+
+        static sos::Base Boolean(bool value)
+        {
+            return sos::Boolean(value);
+        }
+
+        static sos::Base Array()
+        {
+            return sos::Array();
+        }
+
+        static sos::Base Object()
+        {
+            return sos::Object();
+        }
+
+        static void push(sos::Base& array, sos::Base&& value)
+        {
+            array.push(value);
+        }
+
+        static void set(sos::Base& object, const std::string& key, sos::Base&& value)
+        {
+            object.set(key, value);
+        }
+    };
+
+    template <>
+    struct CompactValueTraits<JSONValue> {
+        static JSONValue Null()
+        {
+            return JSONValue::Null();
+        }
+
+        static JSONValue String(const std::string& value)
+        {
+            return JSONValue::String(value);
+        }
+
+        static JSONValue Number(double value)
+        {
+            return JSONValue::Number(value);
+        }
+
+        static JSONValue Boolean(bool value)
+        {
+            return JSONValue::Boolean(value);
+        }
+
+        static JSONValue Array()
+        {
+            return JSONValue::Array();
+        }
+
+        static JSONValue Object()
+        {
+            return JSONValue::Object();
+        }
+
+        static void push(JSONValue& array, JSONValue&& value)
+        {
+            array.push(std::move(value));
+        }
+
+        static void set(JSONValue& object, const std::string& key, JSONValue&& value)
+        {
+            object.add(key, std::move(value));
+        }
+    };
+
+    /**
+     * Compact (value only) serialization of element
+     *
+     * Instantiated for `sos::Base` and `JSONValue`, see `CompactValueTraits`.
+     */
+    template <typename T>
+    class SerializeCompactVisitor
     {
+        typedef CompactValueTraits<T> Traits;
+
         std::string key_;
-        sos::Base value_;
+        T value_;
         bool generateSourceMap;
 
+        template <typename Values>
+        void serializeValues(const Values& values);
+
     public:
-        SosSerializeCompactVisitor() : generateSourceMap(true) {}
-        SosSerializeCompactVisitor(bool generateSourceMap) : generateSourceMap(generateSourceMap) {}
+        SerializeCompactVisitor() : generateSourceMap(true) {}
+        SerializeCompactVisitor(bool generateSourceMap) : generateSourceMap(generateSourceMap) {}
 
         void operator()(const IElement& e);
         void operator()(const NullElement& e);
@@ -41,17 +146,22 @@ namespace refract
         void operator()(const SelectElement& e);
         void operator()(const OptionElement& e);
 
-        std::string key()
+        const std::string& key() const
         {
             return key_;
         }
 
-        sos::Base value()
+        T& value()
         {
             return value_;
         }
     };
 
+    extern template class SerializeCompactVisitor<sos::Base>;
+    extern template class SerializeCompactVisitor<JSONValue>;
+
+    typedef SerializeCompactVisitor<sos::Base> SosSerializeCompactVisitor;
+
 }; // namespace refract
 
 #endif // #ifndef REFRACT_SERIALIZECOMPACTVISITOR_H
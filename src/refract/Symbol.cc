@@ -0,0 +1,69 @@
+//
+//  refract/Symbol.cc
+//  librefract
+//
+
+#include "Symbol.h"
+#include "Element.h"
+
+namespace refract
+{
+
+    namespace
+    {
+        thread_local SymbolTable* CurrentTable = NULL;
+
+        std::shared_ptr<const Symbol::Entry> MakeEntry(const std::string& name)
+        {
+            Symbol::Entry entry = { name, std::hash<std::string>()(name), isReserved(name) };
+            return std::make_shared<const Symbol::Entry>(std::move(entry));
+        }
+    }
+
+    Symbol::Symbol(const std::string& name)
+    {
+        if (name.empty()) {
+            return;
+        }
+
+        if (CurrentTable) {
+            entry_ = CurrentTable->intern(name).entry_;
+        } else {
+            entry_ = MakeEntry(name);
+        }
+    }
+
+    const std::string& Symbol::str() const
+    {
+        static const std::string empty;
+        return entry_ ? entry_->name : empty;
+    }
+
+    const Symbol& SymbolTable::intern(const std::string& name)
+    {
+        static const Symbol empty;
+
+        if (name.empty()) {
+            return empty;
+        }
+
+        Symbol& symbol = symbols[name];
+
+        if (symbol.empty()) {
+            symbol.entry_ = MakeEntry(name);
+        }
+
+        return symbol;
+    }
+
+    SymbolScope::SymbolScope(SymbolTable* table) : previous(CurrentTable)
+    {
+        CurrentTable = table;
+    }
+
+    SymbolScope::~SymbolScope()
+    {
+        CurrentTable = previous;
+    }
+
+}; // namespace refract
@@ -0,0 +1,141 @@
+//
+//  refract/Symbol.h
+//  librefract
+//
+#ifndef REFRACT_SYMBOL_H
+#define REFRACT_SYMBOL_H
+
+#include <string>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
+namespace refract
+{
+
+    class SymbolTable;
+
+    /**
+     * Element name cheap to copy, compare and hash
+     *
+     * Symbols made while a `SymbolScope` is active on the thread share one
+     * copy of every name with the other symbols of its table, so they are
+     * told apart by identity. Any other symbol holds a copy of its own and
+     * compares by name. A name is kept as long as a symbol refers to it.
+     *
+     * A symbol is a counted reference to its name, not an index into the
+     * table: elements outlive the parse that made them and keep no table
+     * an index could be resolved against. Copying a symbol therefore
+     * updates a reference count.
+     */
+    class Symbol
+    {
+    public:
+        /** Name along with its hash and reserved flag */
+        struct Entry {
+            std::string name;
+            std::size_t hash;
+            bool reserved;
+        };
+
+    private:
+        std::shared_ptr<const Entry> entry_;
+
+        friend class SymbolTable;
+
+    public:
+        /** Symbol of empty name */
+        Symbol() {}
+
+        /** Intern name into the current thread table, if any */
+        explicit Symbol(const std::string& name);
+
+        const std::string& str() const;
+
+        bool empty() const
+        {
+            return !entry_;
+        }
+
+        /** True for names of the base elements, see `isReserved()` */
+        bool reserved() const
+        {
+            return entry_ && entry_->reserved;
+        }
+
+        /** True if both symbols refer to one copy of the name */
+        bool same(const Symbol& other) const
+        {
+            return entry_ == other.entry_;
+        }
+
+        bool operator==(const Symbol& other) const
+        {
+            return entry_ == other.entry_
+                || (entry_ && other.entry_ && entry_->hash == other.entry_->hash && entry_->name == other.entry_->name);
+        }
+
+        bool operator!=(const Symbol& other) const
+        {
+            return !(*this == other);
+        }
+
+        std::size_t hash() const
+        {
+            return entry_ ? entry_->hash : 0;
+        }
+    };
+
+    /**
+     * Names interned by one parse, see `ConversionContext`
+     *
+     * Not thread safe, every thread converting a blueprint interns into
+     * a table of its own. Names outlive the table while symbols refer
+     * to them.
+     */
+    class SymbolTable
+    {
+        std::unordered_map<std::string, Symbol> symbols;
+
+    public:
+        /** Symbol of name shared by all symbols of the table */
+        const Symbol& intern(const std::string& name);
+
+        std::size_t size() const
+        {
+            return symbols.size();
+        }
+    };
+
+    /**
+     * Makes table the one `Symbol(name)` interns into on the current
+     * thread while in scope. NULL table disables interning.
+     */
+    class SymbolScope
+    {
+        SymbolTable* previous;
+
+        SymbolScope(const SymbolScope&);
+        SymbolScope& operator=(const SymbolScope&);
+
+    public:
+        explicit SymbolScope(SymbolTable* table);
+        ~SymbolScope();
+    };
+
+}; // namespace refract
+
+namespace std
+{
+
+    template <>
+    struct hash<refract::Symbol> {
+        std::size_t operator()(const refract::Symbol& symbol) const
+        {
+            return symbol.hash();
+        }
+    };
+}
+
+#endif // #ifndef REFRACT_SYMBOL_H
@@ -209,8 +209,7 @@ namespace refract
 
     // will be moved into different header (as part of drafter instead of refract)
     template <typename T, typename Functor>
-    void HandleRefWhenFetchingMembers(
-        const refract::IElement* e, typename T::ValueType& members, const Functor& functor)
+    void HandleResolvedRef(const refract::IElement* e, const Functor& functor)
     {
         auto const found = e->attributes.find("resolved");
 
@@ -223,7 +222,7 @@ namespace refract
         if (!extended) {
             CheckMixinParent<T>((*found)->value.second);
             // We can safely cast it because we are already checking the type in the above line.
-            functor(static_cast<const T&>(*(*found)->value.second), members);
+            functor(static_cast<const T&>(*(*found)->value.second));
             return;
         }
 
@@ -231,10 +230,18 @@ namespace refract
 
             CheckMixinParent<T>(*it);
             // We can safely cast it because we are already checking the type in the above line.
-            functor(static_cast<const T&>(**it), members);
+            functor(static_cast<const T&>(**it));
         }
     }
 
+    // will be moved into different header (as part of drafter instead of refract)
+    template <typename T, typename Functor>
+    void HandleRefWhenFetchingMembers(
+        const refract::IElement* e, typename T::ValueType& members, const Functor& functor)
+    {
+        HandleResolvedRef<T>(e, [&members, &functor](const T& resolved) { functor(resolved, members); });
+    }
+
     template <typename T>
     MemberElement* FindMemberByKey(const T& e, const std::string& name)
     {
@@ -10,15 +10,15 @@
 
 #include <algorithm>
 #include <iostream>
+#include <iomanip>
 
 #include "refract/Element.h"
-#include "refract/FilterVisitor.h"
-#include "refract/Query.h"
-#include "refract/Iterate.h"
 #include "refract/TypeQueryVisitor.h"
 
 #include "refract/VisitorUtils.h"
 
+#include "DrafterResult.h"
+
 namespace sc = snowcrash;
 
 /** structure contains starting and ending position of a error/warning. */
@@ -240,20 +240,48 @@ struct AnnotationToString {
 
 void PrintReport(const drafter_result* result, const std::string& source, const bool useLineNumbers, const int error)
 {
-    std::cerr << std::endl;
+    sc::ProfileSession session(result ? result->profile.get() : NULL);
+    sc::ProfileScope scope(sc::ReportStage);
 
-    refract::FilterVisitor filter(refract::query::Element("annotation"));
-    refract::Iterate<refract::Children> iterate(filter);
-    iterate(*result);
-
-    refract::RefractElements elements;
+    std::cerr << std::endl;
 
     if (error == sc::Error::OK) {
         std::cerr << "OK.\n";
     }
 
-    std::transform(filter.elements().begin(),
-        filter.elements().end(),
+    size_t count = 0;
+    const drafter_annotation* const* annotations = drafter_annotations(result, &count);
+
+    std::transform(annotations,
+        annotations + count,
         std::ostream_iterator<std::string>(std::cerr, "\n"),
         AnnotationToString(source, useLineNumbers));
 }
+
+void PrintProfile(const drafter_result* result)
+{
+    std::ostream& out = std::cerr;
+    std::ios_base::fmtflags flags = out.flags();
+
+    out << std::endl;
+    out << std::left << std::setw(16) << "stage" << std::right << std::setw(8) << "calls" << std::setw(14)
+        << "total (ms)" << std::setw(14) << "self (ms)" << std::setw(14) << "allocations" << std::setw(14)
+        << "deallocations" << std::setw(14) << "bytes" << std::endl;
+
+    out << std::fixed << std::setprecision(3);
+
+    for (int i = 0; i < DRAFTER_STAGE_COUNT; ++i) {
+        drafter_stage stage = static_cast<drafter_stage>(i);
+        drafter_stage_stats stats;
+
+        if (!drafter_profile_stage(result, stage, &stats)) {
+            break;
+        }
+
+        out << std::left << std::setw(16) << drafter_stage_name(stage) << std::right << std::setw(8) << stats.calls
+            << std::setw(14) << stats.total * 1000 << std::setw(14) << stats.self * 1000 << std::setw(14)
+            << stats.allocations << std::setw(14) << stats.deallocations << std::setw(14) << stats.bytes << std::endl;
+    }
+
+    out.flags(flags);
+}
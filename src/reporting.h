@@ -31,4 +31,11 @@ void PrintReport(const snowcrash::Report& report, const std::string& source, con
  */
 void PrintReport(const drafter_result*, const std::string& source, const bool useLineNumbers, const int error);
 
+/**
+ *  \brief Print per-stage profile of parse result to stderr.
+ *
+ *  \param result Parse result obtained with profile option
+ */
+void PrintProfile(const drafter_result* result);
+
 #endif // #ifndef DRAFTER_REPORTING_H
@@ -0,0 +1,483 @@
+//
+//  perf-drafter.cc
+//  drafter
+//
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include "drafter.h"
+
+#if defined(_MSC_VER)
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+static const int DefaultRunCount = 100;
+
+/**
+ *  \brief Timing and per-stage statistics of one benchmark
+ */
+struct Benchmark {
+    std::string name;
+    int runs;
+    int result;
+    double total;
+    double mean;
+    double stddev;
+    drafter_stage_stats stages[DRAFTER_STAGE_COUNT];
+
+    Benchmark(const std::string& name) : name(name), runs(0), result(0), total(0), mean(0), stddev(0)
+    {
+        memset(stages, 0, sizeof(stages));
+    }
+};
+
+typedef std::vector<Benchmark> Benchmarks;
+
+/**
+ *  \brief Running sums of a benchmark
+ */
+class Timer
+{
+    typedef std::chrono::steady_clock Clock;
+
+    Clock::time_point start;
+    double sum;
+    double sum2;
+    int count;
+
+public:
+    Timer() : sum(0), sum2(0), count(0) {}
+
+    void begin()
+    {
+        start = Clock::now();
+    }
+
+    void end()
+    {
+        double t = std::chrono::duration<double>(Clock::now() - start).count();
+        sum += t;
+        sum2 += t * t;
+        ++count;
+    }
+
+    void fill(Benchmark& benchmark) const
+    {
+        benchmark.runs = count;
+        benchmark.total = sum;
+        benchmark.mean = count ? sum / count : 0;
+        benchmark.stddev = count ? std::sqrt(std::fabs((sum2 / count) - (benchmark.mean * benchmark.mean))) : 0;
+    }
+};
+
+/**
+ *  \brief Add statistics of result profile to benchmark stages
+ */
+static void AccumulateStages(Benchmark& benchmark, const drafter_result* result)
+{
+    for (int i = 0; i < DRAFTER_STAGE_COUNT; ++i) {
+        drafter_stage_stats stats;
+
+        if (!drafter_profile_stage(result, static_cast<drafter_stage>(i), &stats)) {
+            return;
+        }
+
+        drafter_stage_stats& sum = benchmark.stages[i];
+
+        sum.total += stats.total;
+        sum.self += stats.self;
+        sum.calls += stats.calls;
+        sum.allocations += stats.allocations;
+        sum.deallocations += stats.deallocations;
+        sum.bytes += stats.bytes;
+    }
+}
+
+/**
+ *  \brief Default parse options, with profile recorded if `profile` is set
+ */
+static drafter_parse_options_ex ParseOptions(bool profile)
+{
+    drafter_parse_options_ex options;
+    drafter_init_parse_options(&options);
+
+    options.profile = profile;
+
+    return options;
+}
+
+/**
+ *  \brief  Benchmark `drafter_parse_blueprint()`
+ *
+ *  Runs are timed without profile, stages are recorded by the same
+ *  number of separate runs so profiling does not add to the timing.
+ */
+static Benchmark BenchmarkParse(const std::string& source, int runs)
+{
+    Benchmark benchmark("parse");
+    Timer timer;
+
+    const drafter_parse_options_ex options = ParseOptions(false);
+
+    for (int i = 0; i < runs; ++i) {
+        drafter_result* result = NULL;
+
+        timer.begin();
+        benchmark.result = drafter_parse_blueprint_ex(source.c_str(), &result, &options);
+        timer.end();
+
+        drafter_free_result(result);
+    }
+
+    const drafter_parse_options_ex profileOptions = ParseOptions(true);
+
+    for (int i = 0; i < runs; ++i) {
+        drafter_result* result = NULL;
+
+        drafter_parse_blueprint_ex(source.c_str(), &result, &profileOptions);
+
+        if (result) {
+            AccumulateStages(benchmark, result);
+            drafter_free_result(result);
+        }
+    }
+
+    timer.fill(benchmark);
+    return benchmark;
+}
+
+/**
+ *  \brief  Benchmark `drafter_serialize()` of once parsed result
+ */
+static Benchmark BenchmarkSerialize(const std::string& source, int runs, drafter_format format, bool sourcemap)
+{
+    std::string name = format == DRAFTER_SERIALIZE_JSON ? "serialize-json" : "serialize-yaml";
+
+    if (sourcemap) {
+        name += "-sourcemap";
+    }
+
+    Benchmark benchmark(name);
+    Timer timer;
+
+    drafter_serialize_options options = {};
+    options.sourcemap = sourcemap;
+    options.format = format;
+
+    const drafter_parse_options_ex parseOptions = ParseOptions(false);
+    const drafter_parse_options_ex profileOptions = ParseOptions(true);
+
+    drafter_result* result = NULL;
+
+    benchmark.result = drafter_parse_blueprint_ex(source.c_str(), &result, &parseOptions);
+
+    if (!result) {
+        return benchmark;
+    }
+
+    for (int i = 0; i < runs; ++i) {
+        timer.begin();
+        char* out = drafter_serialize(result, options);
+        timer.end();
+
+        free(out);
+    }
+
+    drafter_free_result(result);
+
+    // Stages are recorded by separate runs on profiled result
+    result = NULL;
+    drafter_parse_blueprint_ex(source.c_str(), &result, &profileOptions);
+
+    if (!result) {
+        timer.fill(benchmark);
+        return benchmark;
+    }
+
+    // Keep only the serialization in the profile
+    drafter_stage_stats parsed[DRAFTER_STAGE_COUNT];
+    memset(parsed, 0, sizeof(parsed));
+
+    for (int i = 0; i < DRAFTER_STAGE_COUNT; ++i) {
+        drafter_profile_stage(result, static_cast<drafter_stage>(i), &parsed[i]);
+    }
+
+    for (int i = 0; i < runs; ++i) {
+        free(drafter_serialize(result, options));
+    }
+
+    AccumulateStages(benchmark, result);
+
+    for (int i = 0; i < DRAFTER_STAGE_COUNT; ++i) {
+        benchmark.stages[i].total -= parsed[i].total;
+        benchmark.stages[i].self -= parsed[i].self;
+        benchmark.stages[i].calls -= parsed[i].calls;
+        benchmark.stages[i].allocations -= parsed[i].allocations;
+        benchmark.stages[i].deallocations -= parsed[i].deallocations;
+        benchmark.stages[i].bytes -= parsed[i].bytes;
+    }
+
+    drafter_free_result(result);
+
+    timer.fill(benchmark);
+    return benchmark;
+}
+
+/**
+ *  \brief  Benchmark `drafter_check_blueprint()`
+ *
+ *  Timed and profiled separately as `BenchmarkParse()`
+ */
+static Benchmark BenchmarkCheck(const std::string& source, int runs)
+{
+    Benchmark benchmark("check");
+    Timer timer;
+
+    const drafter_parse_options_ex options = ParseOptions(false);
+
+    for (int i = 0; i < runs; ++i) {
+        drafter_result* result = NULL;
+
+        timer.begin();
+        benchmark.result = drafter_check_blueprint_ex(source.c_str(), &result, &options);
+        timer.end();
+
+        drafter_free_result(result);
+    }
+
+    const drafter_parse_options_ex profileOptions = ParseOptions(true);
+
+    for (int i = 0; i < runs; ++i) {
+        drafter_result* result = NULL;
+
+        drafter_check_blueprint_ex(source.c_str(), &result, &profileOptions);
+
+        if (result) {
+            AccumulateStages(benchmark, result);
+            drafter_free_result(result);
+        }
+    }
+
+    timer.fill(benchmark);
+    return benchmark;
+}
+
+/**
+ *  \brief  Peak resident set size of the process in bytes
+ */
+static size_t PeakRSS()
+{
+#if defined(_MSC_VER)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return counters.PeakWorkingSetSize;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage)) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    return usage.ru_maxrss;
+#else
+    return usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+static double Throughput(const Benchmark& benchmark, size_t size)
+{
+    return benchmark.mean > 0 ? size / benchmark.mean / 1000000 : 0;
+}
+
+static void PrintText(const std::string& input, size_t size, const Benchmarks& benchmarks, size_t peakRSS)
+{
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "input: '" << input << "' (" << size << " bytes)\n";
+
+    for (Benchmarks::const_iterator it = benchmarks.begin(); it != benchmarks.end(); ++it) {
+        std::cout << "\n"
+                  << it->name << " " << it->runs << "-times (" << it->result << "):\n";
+        std::cout << "total: " << it->total << "s mean: " << it->mean * 1000 << " +/- " << it->stddev * 1000
+                  << "ms throughput: " << Throughput(*it, size) << "MB/s\n";
+
+        for (int i = 0; i < DRAFTER_STAGE_COUNT; ++i) {
+            const drafter_stage_stats& stats = it->stages[i];
+
+            if (!stats.calls) {
+                continue;
+            }
+
+            std::cout << "  " << std::left << std::setw(16) << drafter_stage_name(static_cast<drafter_stage>(i))
+                      << std::right << "self: " << std::setw(10) << stats.self * 1000 / it->runs
+                      << "ms allocations: " << std::setw(10) << stats.allocations / it->runs
+                      << " deallocations: " << std::setw(10) << stats.deallocations / it->runs
+                      << " bytes: " << std::setw(12) << stats.bytes / it->runs << "\n";
+        }
+    }
+
+    std::cout << "\npeak rss: " << peakRSS << " bytes\n";
+}
+
+/**
+ *  \brief  Quote and escape string for JSON output
+ */
+static std::string JSONString(const std::string& value)
+{
+    std::ostringstream out;
+    out << '"';
+
+    for (std::string::const_iterator it = value.begin(); it != value.end(); ++it) {
+        const unsigned char c = *it;
+
+        switch (c) {
+            case '"':
+                out << "\\\"";
+                break;
+            case '\\':
+                out << "\\\\";
+                break;
+            case '\n':
+                out << "\\n";
+                break;
+            case '\r':
+                out << "\\r";
+                break;
+            case '\t':
+                out << "\\t";
+                break;
+            default:
+                if (c < 0x20) {
+                    out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec
+                        << std::setfill(' ');
+                } else {
+                    out << c;
+                }
+        }
+    }
+
+    out << '"';
+    return out.str();
+}
+
+static void PrintJSON(const std::string& input, size_t size, const Benchmarks& benchmarks, size_t peakRSS)
+{
+    std::cout << std::setprecision(9);
+    std::cout << "{\"input\":" << JSONString(input) << ",\"size\":" << size << ",\"peakRSS\":" << peakRSS
+              << ",\"benchmarks\":[";
+
+    for (Benchmarks::const_iterator it = benchmarks.begin(); it != benchmarks.end(); ++it) {
+        if (it != benchmarks.begin()) {
+            std::cout << ",";
+        }
+
+        std::cout << "{\"name\":" << JSONString(it->name) << ",\"runs\":" << it->runs << ",\"result\":" << it->result
+                  << ",\"total\":" << it->total << ",\"mean\":" << it->mean << ",\"stddev\":" << it->stddev
+                  << ",\"throughput\":" << Throughput(*it, size) << ",\"stages\":{";
+
+        for (int i = 0; i < DRAFTER_STAGE_COUNT; ++i) {
+            const drafter_stage_stats& stats = it->stages[i];
+
+            if (i) {
+                std::cout << ",";
+            }
+
+            std::cout << "\"" << drafter_stage_name(static_cast<drafter_stage>(i)) << "\":{\"calls\":" << stats.calls
+                      << ",\"total\":" << stats.total << ",\"self\":" << stats.self
+                      << ",\"allocations\":" << stats.allocations << ",\"deallocations\":" << stats.deallocations
+                      << ",\"bytes\":" << stats.bytes << "}";
+        }
+
+        std::cout << "}}";
+    }
+
+    std::cout << "]}\n";
+}
+
+void help()
+{
+    std::cout << "usage: perf-drafter [options] ... <input file>" << std::endl << std::endl;
+    std::cout << "API Blueprint Parser End-to-End Performance Test Tool" << std::endl << std::endl;
+    std::cout << "options:" << std::endl << std::endl;
+    std::cout << "  -n, --runs <count>  number of runs of each benchmark (default " << DefaultRunCount << ")"
+              << std::endl;
+    std::cout << "  -j, --json          print results as JSON" << std::endl;
+    std::cout << "  -h, --help          display this help message" << std::endl;
+    exit(0);
+}
+
+int main(int argc, const char* argv[])
+{
+    int runs = DefaultRunCount;
+    bool json = false;
+    std::string inputFileName;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "-h" || arg == "--help") {
+            help();
+        } else if (arg == "-j" || arg == "--json") {
+            json = true;
+        } else if ((arg == "-n" || arg == "--runs") && i + 1 < argc) {
+            runs = atoi(argv[++i]);
+        } else if (inputFileName.empty()) {
+            inputFileName = arg;
+        } else {
+            std::cerr << "one input file expected\n";
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (inputFileName.empty() || runs <= 0) {
+        std::cerr << "one input file expected\n";
+        exit(EXIT_FAILURE);
+    }
+
+    // Read fixture file
+    std::ifstream inputFileStream(inputFileName.c_str());
+    if (!inputFileStream.is_open()) {
+        std::cerr << "fatal: unable to open input file '" << inputFileName << "'\n";
+        exit(EXIT_FAILURE);
+    }
+
+    std::stringstream inputStream;
+    inputStream << inputFileStream.rdbuf();
+    inputFileStream.close();
+
+    const std::string source = inputStream.str();
+
+    if (!json) {
+        std::cout << "running drafter performance test...\n";
+    }
+
+    Benchmarks benchmarks;
+
+    benchmarks.push_back(BenchmarkParse(source, runs));
+    benchmarks.push_back(BenchmarkSerialize(source, runs, DRAFTER_SERIALIZE_JSON, false));
+    benchmarks.push_back(BenchmarkSerialize(source, runs, DRAFTER_SERIALIZE_JSON, true));
+    benchmarks.push_back(BenchmarkSerialize(source, runs, DRAFTER_SERIALIZE_YAML, false));
+    benchmarks.push_back(BenchmarkSerialize(source, runs, DRAFTER_SERIALIZE_YAML, true));
+    benchmarks.push_back(BenchmarkCheck(source, runs));
+
+    if (json) {
+        PrintJSON(inputFileName, source.size(), benchmarks, PeakRSS());
+    } else {
+        PrintText(inputFileName, source.size(), benchmarks, PeakRSS());
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -213,6 +213,72 @@ TEST_CASE("Iterate<Children> on string", "[Visitor]")
     delete e;
 }
 
+struct OrderFunctor {
+    std::vector<std::string> visited;
+
+    void operator()(const refract::IElement& e)
+    {
+        visited.push_back(e.element());
+    }
+
+    void operator()(const refract::StringElement& e)
+    {
+        visited.push_back(e.value);
+    }
+};
+
+TEST_CASE("Iterate<Recursive> visits elements in document order", "[Visitor]")
+{
+    IElement* e = Fixture::ObjectWithChild();
+
+    OrderFunctor f;
+    Iterate<> i(f);
+    i(*e);
+
+    std::vector<std::string> expected = { "object",
+        "member",
+        "m1",
+        "Str1",
+        "member",
+        "m2",
+        "object",
+        "member",
+        "m2.1",
+        "Str2/1",
+        "member",
+        "m2.2",
+        "null" };
+
+    REQUIRE(f.visited == expected);
+
+    delete e;
+}
+
+TEST_CASE("Iterate<Recursive> on deeply nested arrays", "[Visitor]")
+{
+    const int depth = 5000;
+
+    ArrayElement* root = new ArrayElement;
+    ArrayElement* a = root;
+
+    for (int i = 1; i < depth; ++i) {
+        ArrayElement* child = new ArrayElement;
+        a->push_back(child);
+        a = child;
+    }
+
+    a->push_back(IElement::Create("leaf"));
+
+    Functor f;
+    Iterate<> i(f);
+    i(*root);
+
+    REQUIRE(f.GCounter == depth);
+    REQUIRE(f.SCounter == 1);
+
+    delete root;
+}
+
 TEST_CASE("Query Element name", "[Visitor]")
 {
     ArrayElement* a = new ArrayElement;
@@ -103,11 +103,287 @@ int test_validation()
     return 0;
 }
 
+int test_annotations()
+{
+    drafter_parse_options parseOptions = { false };
+    drafter_result* result = NULL;
+    size_t count = 1;
+
+    assert(drafter_parse_blueprint(source, &result, parseOptions) == 0);
+    assert(drafter_annotations(result, &count) == NULL);
+    assert(count == 0);
+    drafter_free_result(result);
+
+    assert(drafter_parse_blueprint(source_warning, &result, parseOptions) == 0);
+    assert(drafter_annotations(result, &count) != NULL);
+    assert(count == 1);
+    assert(drafter_annotations(result, &count)[0] != NULL);
+    drafter_free_result(result);
+
+    assert(drafter_check_blueprint(source_warning, &result, parseOptions) == 0);
+    assert(drafter_annotations(result, &count) != NULL);
+    assert(count == 1);
+    drafter_free_result(result);
+
+    return 0;
+}
+
+int test_profile()
+{
+    drafter_parse_options_ex parseOptions;
+    drafter_result* result = NULL;
+    drafter_stage_stats stats;
+
+    drafter_init_parse_options(&parseOptions);
+
+    assert(drafter_parse_blueprint_ex(source, &result, &parseOptions) == 0);
+    assert(!drafter_profile_stage(result, DRAFTER_STAGE_MARKDOWN, &stats));
+    drafter_free_result(result);
+
+    parseOptions.profile = true;
+    assert(drafter_parse_blueprint_ex(source, &result, &parseOptions) == 0);
+
+    assert(drafter_profile_stage(result, DRAFTER_STAGE_MARKDOWN, &stats));
+    assert(stats.calls == 1);
+    assert(stats.total >= stats.self);
+
+    assert(drafter_profile_stage(result, DRAFTER_STAGE_BLUEPRINT, &stats));
+    assert(stats.calls == 1);
+
+    assert(drafter_profile_stage(result, DRAFTER_STAGE_SERIALIZE, &stats));
+    assert(stats.calls == 0);
+
+    drafter_serialize_options options = { false };
+    options.sourcemap = false;
+    options.format = DRAFTER_SERIALIZE_JSON;
+
+    char* out = drafter_serialize(result, options);
+    assert(out);
+
+    assert(drafter_profile_stage(result, DRAFTER_STAGE_SERIALIZE, &stats));
+    assert(stats.calls == 1);
+
+    assert(!drafter_profile_stage(result, DRAFTER_STAGE_COUNT, &stats));
+    assert(strcmp(drafter_stage_name(DRAFTER_STAGE_MARKDOWN), "markdown") == 0);
+
+    drafter_free_result(result);
+    free(out);
+    return 0;
+}
+
+int test_trace()
+{
+    drafter_parse_options_ex parseOptions;
+    drafter_result* result = NULL;
+
+    drafter_init_parse_options(&parseOptions);
+
+    assert(drafter_parse_blueprint_ex(source, &result, &parseOptions) == 0);
+    assert(drafter_profile_trace(result) == NULL);
+    drafter_free_result(result);
+
+    parseOptions.trace = true;
+    assert(drafter_parse_blueprint_ex(source, &result, &parseOptions) == 0);
+
+    char* trace = drafter_profile_trace(result);
+    assert(trace);
+
+    assert(strncmp(trace, "{\"traceEvents\":[", 16) == 0);
+    assert(strstr(trace, "\"name\":\"markdown\",\"cat\":\"stage\""));
+    assert(strstr(trace, "\"name\":\"/message\",\"cat\":\"resource\""));
+    assert(strstr(trace, "\"cat\":\"action\""));
+
+    drafter_free_result(result);
+    free(trace);
+    return 0;
+}
+
+int test_parse_options_ex()
+{
+    drafter_parse_options_ex parseOptions;
+    drafter_result* result = NULL;
+    drafter_stage_stats stats;
+
+    /* options not initialized by drafter_init_parse_options() are refused */
+    memset(&parseOptions, 0, sizeof(parseOptions));
+    assert(drafter_parse_blueprint_ex(source, &result, &parseOptions) == DRAFTER_EINVALID_INPUT);
+    assert(drafter_parse_blueprint_ex(source, &result, NULL) == DRAFTER_EINVALID_INPUT);
+    assert(result == NULL);
+
+    /* options beyond size of a caller built with older drafter.h keep their defaults */
+    drafter_init_parse_options(&parseOptions);
+    parseOptions.profile = true;
+    parseOptions.trace = true;
+    parseOptions.size = offsetof(drafter_parse_options_ex, trace);
+
+    assert(drafter_parse_blueprint_ex(source, &result, &parseOptions) == 0);
+    assert(drafter_profile_stage(result, DRAFTER_STAGE_MARKDOWN, &stats));
+    assert(drafter_profile_trace(result) == NULL);
+    drafter_free_result(result);
+
+    assert(drafter_check_blueprint_ex(source_warning, &result, &parseOptions) == 0);
+    assert(result);
+    drafter_free_result(result);
+
+    return 0;
+}
+
+const char* source_references = "# My API\n## GET /team\n+ Response 200 (application/json)\n\n    + Attributes\n"
+                                "        - lead (User)\n        - deputy (User, nullable)\n\n"
+                                "# Data Structures\n## User (object)\n- name: Joe (string)\n";
+
+int test_schema_references()
+{
+    drafter_parse_options_ex parseOptions;
+    drafter_serialize_options options = { false };
+    options.sourcemap = false;
+    options.format = DRAFTER_SERIALIZE_JSON;
+
+    drafter_result* result = NULL;
+    char* out = NULL;
+
+    drafter_init_parse_options(&parseOptions);
+
+    assert(drafter_parse_blueprint_ex(source_references, &result, &parseOptions) == 0);
+    out = drafter_serialize(result, options);
+    assert(out);
+    assert(strstr(out, "$ref") == NULL);
+    drafter_free_result(result);
+    free(out);
+
+    parseOptions.schemaReferences = true;
+    assert(drafter_parse_blueprint_ex(source_references, &result, &parseOptions) == 0);
+    out = drafter_serialize(result, options);
+    assert(out);
+    drafter_free_result(result);
+
+    /* schema is a string in serialized result, its quotes are escaped */
+    assert(strstr(out, "\\\"lead\\\": {\\n      \\\"$ref\\\": \\\"#/definitions/User\\\""));
+    assert(strstr(out, "\\\"anyOf\\\": ["));
+    assert(strstr(out, "\\\"definitions\\\": {\\n    \\\"User\\\": {"));
+
+    free(out);
+    return 0;
+}
+
+const char* source_lazy = "# My API\n## GET /team\n+ Response 200 (application/json)\n\n    + Attributes\n"
+                          "        - name: Joe (string)\n        - size: 3 (number)\n\n"
+                          "+ Response 204 (text/plain)\n\n"
+                          "+ Response 400 (application/json)\n\n    + Body\n\n            {}\n\n"
+                          "    + Schema\n\n            {\"type\": \"object\"}\n";
+
+int test_lazy_render()
+{
+    drafter_parse_options parseOptions = { false };
+    drafter_parse_options_ex lazyOptions;
+    drafter_serialize_options options = { false };
+    options.sourcemap = true;
+    options.format = DRAFTER_SERIALIZE_JSON;
+
+    char* eager = NULL;
+    assert(drafter_parse_blueprint_to(source_lazy, &eager, parseOptions, options) == 0);
+    assert(eager);
+
+    drafter_result* result = NULL;
+    drafter_init_parse_options(&lazyOptions);
+    lazyOptions.lazyRender = true;
+    assert(drafter_parse_blueprint_ex(source_lazy, &result, &lazyOptions) == 0);
+    assert(result);
+
+    /* annotations are completed by the first call, serialization does not change them */
+    size_t count = 0;
+    size_t serializedCount = 0;
+    const drafter_annotation* const* annotations = drafter_annotations(result, &count);
+
+    /* the first serialization renders assets, the next ones see them rendered */
+    char* lazy = drafter_serialize(result, options);
+    assert(lazy);
+    assert(strcmp(eager, lazy) == 0);
+    free(lazy);
+
+    lazy = drafter_serialize(result, options);
+    assert(lazy);
+    assert(strcmp(eager, lazy) == 0);
+    free(lazy);
+
+    assert(drafter_annotations(result, &serializedCount) == annotations);
+    assert(serializedCount == count);
+
+    drafter_free_result(result);
+    free(eager);
+    return 0;
+}
+
+int test_serialize_threads()
+{
+    drafter_parse_options parseOptions = { false };
+    drafter_serialize_options_ex options;
+    drafter_init_serialize_options(&options);
+    options.sourcemap = true;
+    options.format = DRAFTER_SERIALIZE_JSON;
+
+    drafter_result* result = NULL;
+    assert(drafter_parse_blueprint(source_lazy, &result, parseOptions) == 0);
+    assert(result);
+
+    char* sequential = drafter_serialize_ex(result, &options);
+    assert(sequential);
+
+    /* any result is large enough to be serialized on more threads */
+    options.threads = 4;
+    options.concurrentSize = 1;
+
+    char* threaded = drafter_serialize_ex(result, &options);
+    assert(threaded);
+    assert(strcmp(sequential, threaded) == 0);
+
+    drafter_free_result(result);
+    free(sequential);
+    free(threaded);
+    return 0;
+}
+
+int test_serialize_options_ex()
+{
+    drafter_parse_options parseOptions = { false };
+    drafter_serialize_options_ex options;
+    drafter_result* result = NULL;
+
+    assert(drafter_parse_blueprint(source, &result, parseOptions) == 0);
+
+    /* options not initialized by drafter_init_serialize_options() are refused */
+    memset(&options, 0, sizeof(options));
+    assert(drafter_serialize_ex(result, &options) == NULL);
+    assert(drafter_serialize_ex(result, NULL) == NULL);
+
+    /* options beyond size of a caller built with older drafter.h keep their defaults */
+    drafter_init_serialize_options(&options);
+    options.format = DRAFTER_SERIALIZE_JSON;
+    options.threads = 1000000;
+    options.size = offsetof(drafter_serialize_options_ex, threads);
+
+    char* out = drafter_serialize_ex(result, &options);
+    assert(out);
+    assert(out[0] == '{');
+
+    drafter_free_result(result);
+    free(out);
+    return 0;
+}
+
 int main()
 {
     assert(test_parse_and_serialize() == 0);
     assert(test_parse_to_string() == 0);
     assert(test_version() == 0);
     assert(test_validation() == 0);
+    assert(test_annotations() == 0);
+    assert(test_profile() == 0);
+    assert(test_trace() == 0);
+    assert(test_parse_options_ex() == 0);
+    assert(test_schema_references() == 0);
+    assert(test_lazy_render() == 0);
+    assert(test_serialize_threads() == 0);
+    assert(test_serialize_options_ex() == 0);
     return 0;
 }
@@ -0,0 +1,242 @@
+#include "draftertest.h"
+
+#include "refract/Element.h"
+#include "refract/JSONSchemaVisitor.h"
+
+#include <memory>
+#include <random>
+
+using namespace draftertest;
+using namespace refract;
+
+namespace
+{
+    /**
+     * Random data structures built of all the elements JSON Schema is generated for
+     *
+     * Only raw output of `std::mt19937` is used, distributions are implementation
+     * defined and would produce other structures with other standard libraries.
+     */
+    class DataStructureGenerator
+    {
+        std::mt19937 engine;
+
+        int random(int n)
+        {
+            return engine() % n;
+        }
+
+        IElement* string(const char* value)
+        {
+            return IElement::Create(value);
+        }
+
+        void typeAttributes(IElement* e)
+        {
+            static const char* const Attributes[] = { "fixed", "fixedType", "required", "nullable", "optional" };
+
+            ArrayElement* attributes = new ArrayElement;
+
+            for (int n = random(3); n > 0; --n) {
+                attributes->push_back(string(Attributes[random(5)]));
+            }
+
+            e->attributes["typeAttributes"] = attributes;
+        }
+
+        void meta(IElement* e)
+        {
+            if (random(4) == 0) {
+                typeAttributes(e);
+            }
+
+            if (random(5) == 0) {
+                e->meta["description"] = string(random(2) ? "desc" : "multi\nline");
+            }
+        }
+
+        void defaultValue(IElement* e)
+        {
+            if (random(5) != 0) {
+                return;
+            }
+
+            if (dynamic_cast<StringElement*>(e)) {
+                e->attributes["default"] = string("dflt");
+            } else if (dynamic_cast<NumberElement*>(e)) {
+                e->attributes["default"] = IElement::Create(3.5);
+            }
+        }
+
+        IElement* enumeration()
+        {
+            EnumElement* e = new EnumElement;
+
+            if (random(3)) {
+                if (random(2)) {
+                    e->set(new StringElement("v"));
+                } else {
+                    e->set(new NumberElement(1));
+                }
+            }
+
+            if (random(4)) {
+                ArrayElement* enumerations = new ArrayElement;
+
+                for (int n = 1 + random(3); n > 0; --n) {
+                    switch (random(4)) {
+                        case 0:
+                            enumerations->push_back(new StringElement("e1"));
+                            break;
+                        case 1:
+                            enumerations->push_back(new NumberElement(2));
+                            break;
+                        case 2:
+                            enumerations->push_back(new BooleanElement(true));
+                            break;
+                        default:
+                            enumerations->push_back(new StringElement);
+                    }
+                }
+
+                e->attributes["enumerations"] = enumerations;
+            }
+
+            return e;
+        }
+
+        IElement* primitive()
+        {
+            IElement* e;
+
+            switch (random(5)) {
+                case 0:
+                    e = random(3) == 0 ? new StringElement : new StringElement(random(2) ? "hello" : "q\"\\\n");
+                    break;
+                case 1:
+                    e = random(3) == 0 ? new NumberElement : new NumberElement(random(2) ? 42 : 1.5);
+                    break;
+                case 2:
+                    e = random(3) == 0 ? new BooleanElement : new BooleanElement(random(2));
+                    break;
+                case 3:
+                    e = new NullElement;
+                    break;
+                default:
+                    e = enumeration();
+            }
+
+            meta(e);
+            defaultValue(e);
+
+            return e;
+        }
+
+        IElement* select()
+        {
+            static const char* const Keys[] = { "a", "b", "c" };
+
+            SelectElement* select = new SelectElement;
+
+            for (int n = 1 + random(2); n > 0; --n) {
+                OptionElement* option = new OptionElement;
+                const char* key = Keys[random(3)];
+                option->push_back(new MemberElement(key, primitive()));
+                select->push_back(option);
+            }
+
+            return select;
+        }
+
+        template <typename T>
+        void fill(T* container, int depth, bool object)
+        {
+            static const char* const Keys[] = { "a", "b", "c", "a\"b", "n\nl", "" };
+
+            for (int n = random(5); n > 0; --n) {
+                IElement* item;
+
+                if (object || random(5) == 0) {
+                    const char* key = Keys[random(6)];
+                    MemberElement* member = new MemberElement(key, generate(depth));
+
+                    if (random(8) == 0) {
+                        member->value.first->attributes["variable"] = IElement::Create(true);
+                    }
+
+                    meta(member);
+                    item = member;
+                } else {
+                    item = generate(depth);
+                }
+
+                if (object && random(8) == 0) {
+                    delete item;
+                    item = select();
+                }
+
+                container->push_back(item);
+            }
+        }
+
+    public:
+        explicit DataStructureGenerator(unsigned seed) : engine(seed) {}
+
+        IElement* generate(int depth)
+        {
+            if (depth <= 0) {
+                return primitive();
+            }
+
+            IElement* e;
+
+            switch (random(6)) {
+                case 0:
+                case 1: {
+                    ObjectElement* object = new ObjectElement;
+                    fill(object, depth - 1, true);
+                    e = object;
+                    break;
+                }
+
+                case 2: {
+                    ArrayElement* array = new ArrayElement;
+                    fill(array, depth - 1, false);
+                    e = array;
+                    break;
+                }
+
+                default:
+                    return primitive();
+            }
+
+            meta(e);
+            return e;
+        }
+    };
+}
+
+// Expected schemas were made by the implementation assembling the schema of refract
+// elements and serializing it by sos, output of the JSONValue based one is the same
+TEST_CASE("JSON Schema of random data structures", "[schema]")
+{
+    const int Seeds = 200;
+    const std::string expected = ITFixtureFiles("test/fixtures/schema/random-data-structures").get(ext::json);
+
+    std::string::size_type position = 0;
+
+    for (int seed = 0; seed < Seeds; ++seed) {
+        INFO("seed " << seed);
+
+        DataStructureGenerator generator(seed);
+        std::unique_ptr<IElement> element(generator.generate(4));
+
+        JSONSchemaVisitor visitor;
+        const std::string schema = (seed ? ",\n" : "[\n") + visitor.getSchema(*element);
+
+        REQUIRE(expected.compare(position, schema.size(), schema) == 0);
+        position += schema.size();
+    }
+
+    REQUIRE(expected.substr(position) == "\n]\n");
+}
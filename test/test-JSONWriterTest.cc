@@ -0,0 +1,349 @@
+#include "catch.hpp"
+
+#include "refract/JSONWriter.h"
+
+#include <clocale>
+#include <locale>
+#include <string>
+
+using namespace refract;
+
+TEST_CASE("Write nested objects and arrays", "[jsonwriter]")
+{
+    JSONWriter writer;
+
+    writer.beginObject();
+    writer.key("a");
+    writer.number(1);
+    writer.key("b");
+    writer.beginArray();
+    writer.item();
+    writer.string("x");
+    writer.item();
+    writer.beginObject();
+    writer.endObject();
+    writer.item();
+    writer.beginArray();
+    writer.endArray();
+    writer.endArray();
+    writer.key("c");
+    writer.null();
+    writer.endObject();
+
+    REQUIRE(writer.str()
+        == "{\n"
+           "  \"a\": 1,\n"
+           "  \"b\": [\n"
+           "    \"x\",\n"
+           "    {},\n"
+           "    []\n"
+           "  ],\n"
+           "  \"c\": null\n"
+           "}");
+}
+
+TEST_CASE("Escape strings and keys", "[jsonwriter]")
+{
+    JSONWriter writer;
+
+    writer.beginObject();
+    writer.key("quote\"d");
+    writer.string("back\\slash\nnew line \"quoted\"");
+    writer.endObject();
+
+    REQUIRE(writer.str()
+        == "{\n"
+           "  \"quote\\\"d\": \"back\\\\slash\\nnew line \\\"quoted\\\"\"\n"
+           "}");
+}
+
+TEST_CASE("Write numbers as default formatted stream", "[jsonwriter]")
+{
+    JSONWriter writer;
+
+    writer.beginArray();
+    writer.item();
+    writer.number(42);
+    writer.item();
+    writer.number(-0.5);
+    writer.item();
+    writer.number(3.14159265);
+    writer.item();
+    writer.number(1e21);
+    writer.item();
+    writer.boolean(true);
+    writer.endArray();
+
+    REQUIRE(writer.str() == "[\n  42,\n  -0.5,\n  3.14159,\n  1e+21,\n  true\n]");
+}
+
+TEST_CASE("Write numbers independently of C locale", "[jsonwriter]")
+{
+    const char* const CommaLocales[] = { "de_DE.UTF-8", "de_DE.utf8", "de_DE", "cs_CZ.UTF-8", "fr_FR.UTF-8" };
+
+    std::string previous = setlocale(LC_NUMERIC, NULL);
+    const char* locale = NULL;
+
+    for (const char* candidate : CommaLocales) {
+        if (setlocale(LC_NUMERIC, candidate)) {
+            locale = candidate;
+            break;
+        }
+    }
+
+    if (!locale) {
+        WARN("no locale with decimal comma available");
+        return;
+    }
+
+    JSONWriter writer;
+    writer.number(0.5);
+
+    setlocale(LC_NUMERIC, previous.c_str());
+
+    REQUIRE(writer.str() == "0.5");
+}
+
+namespace
+{
+    struct CommaNumpunct : std::numpunct<char> {
+        char do_decimal_point() const
+        {
+            return ',';
+        }
+
+        char do_thousands_sep() const
+        {
+            return '.';
+        }
+
+        std::string do_grouping() const
+        {
+            return "\3";
+        }
+    };
+}
+
+TEST_CASE("Write numbers independently of global locale", "[jsonwriter]")
+{
+    std::locale previous = std::locale::global(std::locale(std::locale::classic(), new CommaNumpunct));
+
+    JSONWriter writer;
+    writer.number(1234.5);
+
+    std::locale::global(previous);
+
+    REQUIRE(writer.str() == "1234.5");
+}
+
+TEST_CASE("Repeated key keeps first position and last value", "[jsonwriter]")
+{
+    JSONWriter writer;
+
+    writer.beginObject();
+    writer.key("a");
+    writer.string("first");
+    writer.key("b");
+    writer.number(1);
+    writer.key("a");
+    writer.beginObject();
+    writer.key("nested");
+    writer.string("longer than the first value");
+    writer.endObject();
+    writer.key("c");
+    writer.number(2);
+    writer.key("b");
+    writer.number(3);
+    writer.endObject();
+
+    REQUIRE(writer.str()
+        == "{\n"
+           "  \"a\": {\n"
+           "    \"nested\": \"longer than the first value\"\n"
+           "  },\n"
+           "  \"b\": 3,\n"
+           "  \"c\": 2\n"
+           "}");
+}
+
+TEST_CASE("Repeated key is relocated in object with many keys", "[jsonwriter]")
+{
+    JSONWriter writer;
+    std::string expected = "{\n";
+
+    writer.beginObject();
+
+    for (int i = 0; i < 40; ++i) {
+        writer.key("k" + std::to_string(i));
+        writer.number(i);
+    }
+
+    // repeat every third key, growing and shrinking values
+    for (int i = 0; i < 40; i += 3) {
+        writer.key("k" + std::to_string(i));
+        writer.string(std::string(i % 2 ? 1 : 20, 'v'));
+    }
+
+    writer.endObject();
+
+    for (int i = 0; i < 40; ++i) {
+        expected += "  \"k" + std::to_string(i) + "\": ";
+        expected += i % 3 ? std::to_string(i) : "\"" + std::string(i % 2 ? 1 : 20, 'v') + "\"";
+        expected += i < 39 ? ",\n" : "\n";
+    }
+
+    expected += "}";
+
+    REQUIRE(writer.str() == expected);
+}
+
+TEST_CASE("Repeated keys are told apart per object", "[jsonwriter]")
+{
+    JSONWriter writer;
+
+    writer.beginObject();
+    writer.key("a");
+    writer.beginObject();
+    writer.key("a");
+    writer.number(1);
+    writer.endObject();
+    writer.key("b");
+    writer.beginObject();
+    writer.key("a");
+    writer.number(2);
+    writer.endObject();
+    writer.endObject();
+
+    REQUIRE(writer.str()
+        == "{\n"
+           "  \"a\": {\n"
+           "    \"a\": 1\n"
+           "  },\n"
+           "  \"b\": {\n"
+           "    \"a\": 2\n"
+           "  }\n"
+           "}");
+}
+
+TEST_CASE("Rollback drops items written after mark", "[jsonwriter]")
+{
+    JSONWriter writer;
+
+    writer.beginArray();
+    writer.item();
+    writer.number(1);
+
+    JSONWriter::Mark mark = writer.mark();
+
+    writer.item();
+    writer.beginObject();
+    writer.key("dropped");
+    writer.null();
+    writer.endObject();
+
+    writer.rollback(mark);
+
+    writer.item();
+    writer.number(2);
+    writer.endArray();
+
+    REQUIRE(writer.str() == "[\n  1,\n  2\n]");
+}
+
+TEST_CASE("Rollback of first member leaves object empty", "[jsonwriter]")
+{
+    JSONWriter writer;
+
+    writer.beginObject();
+
+    JSONWriter::Mark mark = writer.mark();
+
+    writer.key("dropped");
+    writer.number(1);
+    writer.rollback(mark);
+
+    writer.endObject();
+
+    REQUIRE(writer.str() == "{}");
+}
+
+TEST_CASE("Rolled back key is not a duplicate", "[jsonwriter]")
+{
+    for (int keys : { 1, 20 }) {
+        INFO("keys " << keys);
+
+        JSONWriter writer;
+        std::string expected = "{\n";
+
+        writer.beginObject();
+
+        for (int i = 0; i < keys; ++i) {
+            writer.key("k" + std::to_string(i));
+            writer.number(i);
+            expected += "  \"k" + std::to_string(i) + "\": " + std::to_string(i) + ",\n";
+        }
+
+        JSONWriter::Mark mark = writer.mark();
+
+        writer.key("dropped");
+        writer.number(1);
+        writer.rollback(mark);
+
+        // new key takes place of the dropped one
+        writer.key("other");
+        writer.number(2);
+
+        writer.key("dropped");
+        writer.number(3);
+
+        writer.key("other");
+        writer.number(4);
+
+        writer.endObject();
+
+        expected += "  \"other\": 4,\n  \"dropped\": 3\n}";
+
+        REQUIRE(writer.str() == expected);
+    }
+}
+
+TEST_CASE("Rollback of repeated key keeps first value", "[jsonwriter]")
+{
+    JSONWriter writer;
+
+    writer.beginObject();
+    writer.key("a");
+    writer.number(1);
+
+    JSONWriter::Mark mark = writer.mark();
+
+    writer.key("a");
+    writer.number(2);
+    writer.rollback(mark);
+
+    writer.endObject();
+
+    REQUIRE(writer.str() == "{\n  \"a\": 1\n}");
+}
+
+TEST_CASE("Raw JSON is indented to current level", "[jsonwriter]")
+{
+    JSONWriter inner;
+    inner.beginObject();
+    inner.key("a");
+    inner.string("multi\nline");
+    inner.endObject();
+
+    JSONWriter writer;
+    writer.beginArray();
+    writer.item();
+    writer.raw(inner.str());
+    writer.endArray();
+
+    REQUIRE(writer.str()
+        == "[\n"
+           "  {\n"
+           "    \"a\": \"multi\\nline\"\n"
+           "  }\n"
+           "]");
+}
@@ -35,3 +35,146 @@ TEST_REFRACT("api", "attributes-named-type-mixin");
 TEST_REFRACT("api", "attributes-named-type-enum-reference");
 
 TEST_REFRACT("api", "mixin-inheritance");
+
+namespace
+{
+    const char* const ConcurrencyFixtures[] = { "api/action",
+        "api/advanced-action",
+        "api/asset",
+        "api/attributes-references",
+        "api/action-request-attributes",
+        "api/mixin-inheritance",
+        "api/mson",
+        "api/payload-attributes",
+        "api/resource-group",
+        "api/schema-body",
+        "api/schema-custom",
+        "api/transaction",
+        "api/xml-body",
+        "render/complex-object",
+        "render/content-type",
+        "render/inheritance-object-sample",
+        "render/issue-318",
+        "render/mixin-override",
+        "render/nullable",
+        "render/object-samples" };
+
+    std::string SerializeFixture(const char* fixture, const drafter::WrapperOptions& options)
+    {
+        ITFixtureFiles files(std::string("test/fixtures/") + fixture);
+        snowcrash::ParseResult<snowcrash::Blueprint> blueprint;
+        snowcrash::parse(files.get(ext::apib), snowcrash::ExportSourcemapOption, blueprint);
+
+        std::stringstream out;
+        sos::SerializeJSON serializer;
+        serializer.process(FixtureHelper::parseAndSerialize(blueprint, options), out);
+
+        return out.str();
+    }
+}
+
+TEST_CASE("Rendering payloads on more threads gives the same result", "[refract][threads]")
+{
+    for (const char* fixture : ConcurrencyFixtures) {
+        INFO(fixture);
+
+        const std::string sequential = SerializeFixture(fixture, drafter::WrapperOptions(true, false));
+        const std::string threaded = SerializeFixture(fixture, drafter::WrapperOptions(true, false, false, false, 4));
+
+        REQUIRE(threaded == sequential);
+    }
+}
+
+TEST_CASE("Converting resource groups on more threads gives the same result", "[refract][threads]")
+{
+    for (const char* fixture : ConcurrencyFixtures) {
+        INFO(fixture);
+
+        const std::string sequential = SerializeFixture(fixture, drafter::WrapperOptions(true, false));
+        const std::string threaded
+            = SerializeFixture(fixture, drafter::WrapperOptions(true, false, false, false, 0, 4));
+        const std::string both = SerializeFixture(fixture, drafter::WrapperOptions(true, false, false, false, 4, 4));
+
+        REQUIRE(threaded == sequential);
+        REQUIRE(both == sequential);
+    }
+}
+
+TEST_CASE("Serializing on more threads gives the same result", "[refract][threads]")
+{
+    for (const char* fixture : ConcurrencyFixtures) {
+        INFO(fixture);
+
+        const std::string sequential = SerializeFixture(fixture, drafter::WrapperOptions(true, false));
+        const std::string threaded
+            = SerializeFixture(fixture, drafter::WrapperOptions(true, false, false, false, 0, 0, 4, 1));
+
+        REQUIRE(threaded == sequential);
+    }
+}
+
+namespace
+{
+    refract::IElement* CreateLargeParseResult(size_t groups, size_t resources)
+    {
+        const std::string description(256, 'x');
+
+        refract::ArrayElement* api = new refract::ArrayElement;
+        api->element(drafter::SerializeKey::Category);
+        api->meta[drafter::SerializeKey::Title] = refract::IElement::Create("Large API");
+
+        for (size_t i = 0; i < groups; ++i) {
+            refract::ArrayElement* group = new refract::ArrayElement;
+            group->element(drafter::SerializeKey::Category);
+            group->meta[drafter::SerializeKey::Title] = refract::IElement::Create("Group " + std::to_string(i));
+
+            for (size_t j = 0; j < resources; ++j) {
+                refract::ArrayElement* resource = new refract::ArrayElement;
+                resource->element(drafter::SerializeKey::Resource);
+                resource->attributes[drafter::SerializeKey::Href] = refract::IElement::Create("/" + std::to_string(j));
+                resource->push_back(refract::IElement::Create(description));
+                resource->push_back(refract::IElement::Create(static_cast<double>(j)));
+
+                group->push_back(resource);
+            }
+
+            api->push_back(group);
+        }
+
+        refract::ArrayElement* parseResult = new refract::ArrayElement;
+        parseResult->element(drafter::SerializeKey::ParseResult);
+        parseResult->push_back(api);
+        parseResult->push_back(refract::IElement::Create("warning"));
+
+        return parseResult;
+    }
+
+    std::string SerializeResult(
+        refract::IElement* result, const drafter::WrapperOptions& options, sos::Serialize& serializer)
+    {
+        drafter::ConversionContext context(options);
+
+        std::stringstream out;
+        serializer.process(drafter::SerializeRefract(result, context), out);
+
+        return out.str();
+    }
+}
+
+TEST_CASE("Serializing result larger than concurrent size on more threads gives the same text", "[refract][threads]")
+{
+    const size_t concurrentSize = 16 * 1024;
+    std::unique_ptr<refract::IElement> result(CreateLargeParseResult(8, 64));
+
+    const drafter::WrapperOptions sequential(true, false);
+    const drafter::WrapperOptions threaded(true, false, false, false, 0, 0, 4, concurrentSize);
+
+    sos::SerializeJSON json;
+    sos::SerializeYAML yaml;
+
+    const std::string text = SerializeResult(result.get(), sequential, json);
+
+    REQUIRE(text.size() > 4 * concurrentSize);
+    REQUIRE(SerializeResult(result.get(), threaded, json) == text);
+    REQUIRE(SerializeResult(result.get(), threaded, yaml) == SerializeResult(result.get(), sequential, yaml));
+}
@@ -0,0 +1,208 @@
+#include "catch.hpp"
+
+#include "refract/Element.h"
+#include "refract/Registry.h"
+#include "refract/Exception.h"
+
+#include <memory>
+
+using namespace refract;
+
+namespace
+{
+    /** Named type element reporting its destruction */
+    struct TrackedElement : StringElement {
+        bool& deleted;
+
+        TrackedElement(const std::string& name, bool& deleted) : deleted(deleted)
+        {
+            meta["id"] = IElement::Create(name);
+            deleted = false;
+        }
+
+        ~TrackedElement()
+        {
+            deleted = true;
+        }
+    };
+
+    /** Named type `name` inheriting from `base` */
+    template <typename T = ObjectElement>
+    T* NamedType(const std::string& name, const std::string& base = std::string())
+    {
+        T* element = new T;
+        element->meta["id"] = IElement::Create(name);
+
+        if (!base.empty()) {
+            element->element(base);
+        }
+
+        return element;
+    }
+}
+
+TEST_CASE("Registry owns registered elements", "[registry]")
+{
+    bool removed = false;
+    bool cleared = false;
+    bool destroyed = false;
+
+    {
+        Registry registry;
+
+        REQUIRE(registry.add(new TrackedElement("Removed", removed)));
+        REQUIRE(registry.add(new TrackedElement("Cleared", cleared)));
+
+        REQUIRE(registry.remove("Removed"));
+        REQUIRE(removed);
+        REQUIRE(!registry.find("Removed"));
+        REQUIRE(!registry.remove("Removed"));
+
+        REQUIRE(!cleared);
+        registry.clearAll();
+        REQUIRE(cleared);
+        REQUIRE(!registry.find("Cleared"));
+
+        REQUIRE(registry.add(new TrackedElement("Destroyed", destroyed)));
+        REQUIRE(!destroyed);
+    }
+
+    REQUIRE(destroyed);
+}
+
+TEST_CASE("Registry rejects duplicate and leaves it to caller", "[registry]")
+{
+    bool first = false;
+    bool duplicate = false;
+
+    Registry registry;
+
+    REQUIRE(registry.add(new TrackedElement("Person", first)));
+
+    TrackedElement* rejected = new TrackedElement("Person", duplicate);
+    REQUIRE(!registry.add(rejected));
+    REQUIRE(!duplicate);
+    REQUIRE(registry.find("Person") != rejected);
+
+    delete rejected;
+    REQUIRE(duplicate);
+    REQUIRE(!first);
+}
+
+TEST_CASE("Registry rejects reserved names and elements without id", "[registry]")
+{
+    Registry registry;
+
+    std::unique_ptr<IElement> reserved(NamedType("object"));
+    REQUIRE_THROWS_AS(registry.add(reserved.get()), LogicError);
+
+    std::unique_ptr<IElement> anonymous(new ObjectElement);
+    REQUIRE_THROWS_AS(registry.add(anonymous.get()), LogicError);
+
+    std::unique_ptr<IElement> numeric(new ObjectElement);
+    numeric->meta["id"] = IElement::Create(42.0);
+    REQUIRE_THROWS_AS(registry.add(numeric.get()), LogicError);
+
+    REQUIRE(!registry.find("object"));
+}
+
+TEST_CASE("Registry resolves inheritance chains", "[registry]")
+{
+    Registry registry;
+
+    IElement* base = NamedType<ArrayElement>("Base");
+    IElement* middle = NamedType("Middle", "Base");
+    IElement* leaf = NamedType("Leaf", "Middle");
+    IElement* other = NamedType<StringElement>("Other");
+
+    REQUIRE(registry.add(leaf));
+    REQUIRE(registry.add(middle));
+    REQUIRE(registry.add(base));
+    REQUIRE(registry.add(other));
+
+    // walked before resolve() and looked up after it, the same either way
+    for (int resolved = 0; resolved < 2; ++resolved) {
+        INFO("resolved " << resolved);
+
+        REQUIRE(registry.find("Leaf") == leaf);
+        REQUIRE(registry.findRoot("Leaf") == base);
+        REQUIRE(registry.findRoot("Middle") == base);
+        REQUIRE(registry.findRoot("Base") == base);
+        REQUIRE(registry.findRoot("Other") == other);
+        REQUIRE(FindRootAncestor("Leaf", registry) == base);
+
+        REQUIRE(registry.findRootType("Leaf") == TypeQueryVisitor::Array);
+        REQUIRE(registry.findRootType("Middle") == TypeQueryVisitor::Array);
+        REQUIRE(registry.findRootType("Other") == TypeQueryVisitor::String);
+
+        registry.resolve();
+    }
+}
+
+TEST_CASE("Registry resolves chains broken by unknown names", "[registry]")
+{
+    Registry registry;
+
+    IElement* orphan = NamedType("Orphan", "Missing");
+    IElement* child = NamedType("Child", "Orphan");
+
+    REQUIRE(registry.add(orphan));
+    REQUIRE(registry.add(child));
+
+    for (int resolved = 0; resolved < 2; ++resolved) {
+        INFO("resolved " << resolved);
+
+        // chain ends at the last registered type
+        REQUIRE(registry.findRoot("Child") == orphan);
+        REQUIRE(registry.findRoot("Orphan") == orphan);
+        REQUIRE(registry.findRootType("Child") == TypeQueryVisitor::Object);
+
+        REQUIRE(!registry.find("Missing"));
+        REQUIRE(!registry.findRoot("Missing"));
+        REQUIRE(registry.findRootType("Missing") == TypeQueryVisitor::Unknown);
+        REQUIRE(!registry.find(""));
+
+        registry.resolve();
+    }
+}
+
+TEST_CASE("Registry changes invalidate resolved chains", "[registry]")
+{
+    Registry registry;
+
+    REQUIRE(registry.add(NamedType<ArrayElement>("Base")));
+    REQUIRE(registry.add(NamedType("Leaf", "Base")));
+
+    registry.resolve();
+    REQUIRE(registry.findRootType("Leaf") == TypeQueryVisitor::Array);
+
+    // replace base, as the second pass of named types registration does
+    REQUIRE(registry.remove("Base"));
+    REQUIRE(registry.findRoot("Leaf") == registry.find("Leaf"));
+
+    IElement* base = NamedType<StringElement>("Base");
+    REQUIRE(registry.add(base));
+
+    REQUIRE(registry.findRoot("Leaf") == base);
+    REQUIRE(registry.findRootType("Leaf") == TypeQueryVisitor::String);
+
+    registry.resolve();
+    REQUIRE(registry.findRoot("Leaf") == base);
+
+    registry.clearAll();
+    REQUIRE(!registry.findRoot("Leaf"));
+    REQUIRE(registry.findRootType("Leaf") == TypeQueryVisitor::Unknown);
+}
+
+TEST_CASE("Registry stops at self reference", "[registry]")
+{
+    Registry registry;
+
+    IElement* self = NamedType("Self", "Self");
+    REQUIRE(registry.add(self));
+
+    REQUIRE(registry.findRoot("Self") == self);
+
+    registry.resolve();
+    REQUIRE(registry.findRoot("Self") == self);
+}
@@ -8,6 +8,9 @@
 
 #include "draftertest.h"
 
+#include "Render.h"
+#include "RegexMatch.h"
+
 using namespace draftertest;
 
 TEST_REFRACT("render", "simple-object");
@@ -49,3 +52,105 @@ TEST_REFRACT("render", "issue-328-2");
 TEST_REFRACT("render", "fixed-attributes-section");
 TEST_REFRACT("render", "fixed-named-type");
 TEST_REFRACT("render", "mixin-override");
+
+namespace
+{
+    struct ContentTypeFormat {
+        std::string contentType;
+        drafter::RenderFormat format;
+    };
+
+    const ContentTypeFormat ContentTypeFormats[] = {
+        // JSON
+        { "application/json", drafter::JSONRenderFormat },
+        { "application/hal+json", drafter::JSONRenderFormat },
+        { "application/vnd.api+json", drafter::JSONRenderFormat },
+        { "application/a b+json", drafter::JSONRenderFormat },
+        { "application/+json", drafter::JSONRenderFormat },
+        { "application/json+json", drafter::JSONRenderFormat },
+        { "application/schema+json+json", drafter::JSONRenderFormat },
+        { "application/schema+xml+json", drafter::JSONRenderFormat },
+        { "application/hal+json+xml+json", drafter::JSONRenderFormat },
+        // JSON Schema
+        { "application/schema+json", drafter::JSONSchemaRenderFormat },
+        // parameters
+        { "application/json; charset=utf-8", drafter::JSONRenderFormat },
+        { "application/json;charset=utf-8", drafter::JSONRenderFormat },
+        { "application/json;", drafter::JSONRenderFormat },
+        { "application/problem+json; charset=utf-8", drafter::JSONRenderFormat },
+        { "application/json; type=application/xml", drafter::JSONRenderFormat },
+        { "application/xml; type=application/json", drafter::UndefinedRenderFormat },
+        { "application/schema+json; profile=draft-04", drafter::JSONSchemaRenderFormat },
+        { "application/schema+json;", drafter::JSONSchemaRenderFormat },
+        // whitespace
+        { "  application/json", drafter::JSONRenderFormat },
+        { "\tapplication/hal+json", drafter::JSONRenderFormat },
+        { "application/json  ", drafter::JSONRenderFormat },
+        { "application/json \t ; charset=utf-8", drafter::JSONRenderFormat },
+        { " \tapplication/schema+json\t", drafter::JSONSchemaRenderFormat },
+        { "application/schema+json ;x", drafter::JSONSchemaRenderFormat },
+        { "\napplication/json", drafter::UndefinedRenderFormat },
+        { "application/json\n", drafter::UndefinedRenderFormat },
+        { "application/ json", drafter::UndefinedRenderFormat },
+        { "application /json", drafter::UndefinedRenderFormat },
+        { "application/json x", drafter::UndefinedRenderFormat },
+        { "application/schema+json x", drafter::UndefinedRenderFormat },
+        // case
+        { "APPLICATION/JSON", drafter::UndefinedRenderFormat },
+        { "Application/json", drafter::UndefinedRenderFormat },
+        { "application/JSON", drafter::UndefinedRenderFormat },
+        { "application/hal+JSON", drafter::UndefinedRenderFormat },
+        { "application/Schema+json", drafter::JSONRenderFormat },
+        // other media types
+        { "", drafter::UndefinedRenderFormat },
+        { "application/", drafter::UndefinedRenderFormat },
+        { "application/xml", drafter::UndefinedRenderFormat },
+        { "application/hal+xml", drafter::UndefinedRenderFormat },
+        { "application/jsonp", drafter::UndefinedRenderFormat },
+        { "application/xjson", drafter::UndefinedRenderFormat },
+        { "application/hal+jsonx", drafter::UndefinedRenderFormat },
+        { "application/json+xml", drafter::UndefinedRenderFormat },
+        { "application/schema+jsonx", drafter::UndefinedRenderFormat },
+        { "text/json", drafter::UndefinedRenderFormat },
+        { "text/plain", drafter::UndefinedRenderFormat },
+        { "x application/json", drafter::UndefinedRenderFormat },
+        { "multipart/mixed; boundary=application/json", drafter::UndefinedRenderFormat },
+        // matching stops at NUL
+        { std::string("application/json\0xml", 20), drafter::JSONRenderFormat },
+        { std::string("application/schema+json\0x", 25), drafter::JSONSchemaRenderFormat },
+        { std::string("application/x\0+json", 20), drafter::UndefinedRenderFormat },
+    };
+
+    drafter::RenderFormat RegexRenderFormat(const std::string& contentType)
+    {
+        if (snowcrash::RegexMatch(contentType, drafter::JSONSchemaRegex)) {
+            return drafter::JSONSchemaRenderFormat;
+        } else if (snowcrash::RegexMatch(contentType, drafter::JSONRegex)) {
+            return drafter::JSONRenderFormat;
+        }
+
+        return drafter::UndefinedRenderFormat;
+    }
+}
+
+TEST_CASE("Render format of content type", "[render][content-type]")
+{
+    drafter::RenderFormatCache cache;
+
+    for (const ContentTypeFormat& entry : ContentTypeFormats) {
+        INFO("Content type: '" << entry.contentType << "'");
+
+        REQUIRE(drafter::findRenderFormat(entry.contentType) == entry.format);
+        REQUIRE(cache.find(entry.contentType) == entry.format);
+        REQUIRE(cache.find(entry.contentType) == entry.format);
+    }
+}
+
+TEST_CASE("Render format of content type matches regular expressions", "[render][content-type]")
+{
+    for (const ContentTypeFormat& entry : ContentTypeFormats) {
+        INFO("Content type: '" << entry.contentType << "'");
+
+        REQUIRE(RegexRenderFormat(entry.contentType) == entry.format);
+    }
+}
@@ -115,3 +115,18 @@ TEST_REFRACT("schema", "one-of-complex");
 TEST_REFRACT("schema", "one-of-properties");
 
 TEST_REFRACT("schema", "issue-493-multiple-same-required");
+
+static drafter::WrapperOptions SchemaReferencesOptions(false, false, true);
+
+#define TEST_SCHEMA_REFS(file)                                                                                         \
+    TEST_DRAFTER("Testing JSON Schema references for",                                                                 \
+        "schema-refs",                                                                                                 \
+        file,                                                                                                          \
+        "refract",                                                                                                     \
+        &FixtureHelper::parseAndSerialize,                                                                             \
+        SchemaReferencesOptions,                                                                                       \
+        true)
+
+TEST_SCHEMA_REFS("reference");
+TEST_SCHEMA_REFS("all-of");
+TEST_SCHEMA_REFS("any-of");
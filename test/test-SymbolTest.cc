@@ -0,0 +1,277 @@
+#include "catch.hpp"
+
+#include "refract/Element.h"
+#include "refract/Symbol.h"
+#include "refract/Registry.h"
+#include "refract/ExpandVisitor.h"
+#include "refract/Visitor.h"
+
+#include <memory>
+
+using namespace refract;
+
+TEST_CASE("Symbols of one table share their name", "[symbol]")
+{
+    SymbolTable table;
+    SymbolScope scope(&table);
+
+    Symbol a("Person");
+    Symbol b("Person");
+    Symbol c("Address");
+
+    REQUIRE(a.same(b));
+    REQUIRE(a == b);
+    REQUIRE(a.hash() == b.hash());
+    REQUIRE(&a.str() == &b.str());
+
+    REQUIRE(!a.same(c));
+    REQUIRE(a != c);
+
+    REQUIRE(table.size() == 2);
+}
+
+TEST_CASE("Symbols without table compare by name", "[symbol]")
+{
+    Symbol a("Person");
+    Symbol b("Person");
+
+    REQUIRE(!a.same(b));
+    REQUIRE(a == b);
+    REQUIRE(a.hash() == b.hash());
+    REQUIRE(a.str() == "Person");
+
+    SymbolTable table;
+    SymbolScope scope(&table);
+
+    Symbol interned("Person");
+
+    REQUIRE(interned == a);
+    REQUIRE(interned.hash() == a.hash());
+    REQUIRE(!interned.same(a));
+}
+
+TEST_CASE("Empty symbol is not interned", "[symbol]")
+{
+    SymbolTable table;
+    SymbolScope scope(&table);
+
+    Symbol a;
+    Symbol b("");
+
+    REQUIRE(a.empty());
+    REQUIRE(b.empty());
+    REQUIRE(a == b);
+    REQUIRE(a.str().empty());
+    REQUIRE(!a.reserved());
+
+    REQUIRE(table.size() == 0);
+}
+
+TEST_CASE("Symbols outlive their table", "[symbol]")
+{
+    Symbol symbol;
+
+    {
+        SymbolTable table;
+        SymbolScope scope(&table);
+
+        symbol = Symbol("Person");
+    }
+
+    REQUIRE(symbol.str() == "Person");
+    REQUIRE(symbol == Symbol("Person"));
+}
+
+TEST_CASE("Symbol scopes nest", "[symbol]")
+{
+    SymbolTable outer;
+    SymbolTable inner;
+
+    SymbolScope outerScope(&outer);
+    Symbol a("Person");
+
+    {
+        SymbolScope innerScope(&inner);
+        Symbol b("Person");
+
+        REQUIRE(!a.same(b));
+
+        {
+            SymbolScope disabled(NULL);
+            Symbol c("Person");
+
+            REQUIRE(!c.same(a));
+            REQUIRE(!c.same(b));
+        }
+
+        REQUIRE(Symbol("Person").same(b));
+    }
+
+    REQUIRE(Symbol("Person").same(a));
+
+    REQUIRE(outer.size() == 1);
+    REQUIRE(inner.size() == 1);
+}
+
+TEST_CASE("Element names are interned into current table", "[symbol]")
+{
+    SymbolTable table;
+    SymbolScope scope(&table);
+
+    StringElement a;
+    StringElement b;
+    ObjectElement c;
+
+    a.element("Person");
+    b.element("Person");
+    c.element("Address");
+
+    REQUIRE(a.symbol().same(b.symbol()));
+    REQUIRE(!a.symbol().same(c.symbol()));
+    REQUIRE(!a.symbol().reserved());
+
+    // names of base elements are not interned by any parse
+    StringElement plain;
+
+    REQUIRE(plain.symbol().str() == "string");
+    REQUIRE(plain.symbol().reserved());
+
+    REQUIRE(table.size() == 2);
+
+    std::unique_ptr<IElement> clone(a.clone());
+    REQUIRE(clone->symbol().same(a.symbol()));
+}
+
+TEST_CASE("Expanded reference values are not interned", "[symbol]")
+{
+    Registry registry;
+
+    ObjectElement object;
+    RefElement* ref = new RefElement;
+    ref->set("Missing");
+    object.push_back(ref);
+
+    SymbolTable table;
+    SymbolScope scope(&table);
+
+    ExpandVisitor expander(registry);
+    Visit(expander, object);
+
+    std::unique_ptr<IElement> expanded(expander.get());
+
+    REQUIRE(table.size() == 0);
+}
+
+namespace
+{
+    const char* const ReservedNames[] = {
+        "null",
+        "boolean",
+        "number",
+        "string",
+        "member",
+        "array",
+        "enum",
+        "object",
+        "ref",
+        "select",
+        "option",
+        "extend",
+        "generic",
+    };
+
+    const char* const NotReservedNames[] = {
+        // prefixes and extensions
+        "",
+        "r",
+        "re",
+        "nul",
+        "arra",
+        "numbe",
+        "objec",
+        "boolea",
+        "refs",
+        "nulls",
+        "arrays",
+        "strings",
+        "booleans",
+        "generics",
+        // case
+        "Ref",
+        "NULL",
+        "Enum",
+        "Array",
+        "nUmber",
+        "membeR",
+        "Extend",
+        "String",
+        "sElect",
+        "Object",
+        "oPtion",
+        "Boolean",
+        "GENERIC",
+        // same length and first character
+        "rex",
+        "nope",
+        "envy",
+        "apply",
+        "nuMBer",
+        "mEmber",
+        "extent",
+        "strong",
+        "stream",
+        "selfie",
+        "obtain",
+        "opaque",
+        "booster",
+        "general",
+        // same length, other first character
+        "abc",
+        "xull",
+        "xxxxx",
+        "xxxxxx",
+        "xxxxxxx",
+        "Person",
+    };
+}
+
+TEST_CASE("All base element names are reserved", "[symbol][reserved]")
+{
+    REQUIRE(sizeof(ReservedNames) / sizeof(ReservedNames[0]) == 13);
+
+    for (const char* name : ReservedNames) {
+        INFO(name);
+        REQUIRE(isReserved(std::string(name)));
+        REQUIRE(Symbol(name).reserved());
+    }
+}
+
+TEST_CASE("Names similar to base element names are not reserved", "[symbol][reserved]")
+{
+    for (const char* name : NotReservedNames) {
+        INFO(name);
+        REQUIRE(!isReserved(std::string(name)));
+        REQUIRE(!Symbol(name).reserved());
+    }
+
+    // embedded NUL is part of the name
+    REQUIRE(!isReserved(std::string("ref\0", 4)));
+    REQUIRE(!isReserved(std::string("null\0", 5)));
+}
+
+TEST_CASE("Reserved flag of interned name", "[symbol][reserved]")
+{
+    SymbolTable table;
+    SymbolScope scope(&table);
+
+    REQUIRE(Symbol("string").reserved());
+    REQUIRE(Symbol("string").reserved());
+    REQUIRE(!Symbol("strings").reserved());
+
+    StringElement named;
+    named.element("object");
+    REQUIRE(isReserved(named.symbol()));
+
+    named.element("Object");
+    REQUIRE(!isReserved(named.symbol()));
+}